@@ -0,0 +1,77 @@
+#include "Aggregate.h"
+
+// Function to empty an aggregate
+void resetAggregate(runningAggregate *aggregate) {
+    if (!aggregate) {
+        return;
+    }
+    aggregate->count = 0;
+    aggregate->sum = 0;
+    aggregate->sumSquares = 0;
+    aggregate->min = 0;
+    aggregate->max = 0;
+    aggregate->boundsStale = false;
+}
+
+// Function to add a number to an aggregate
+void addToAggregate(runningAggregate *aggregate, double value) {
+    if (!aggregate) {
+        return;
+    }
+    if (aggregate->count == 0) {
+        aggregate->min = value;
+        aggregate->max = value;
+        aggregate->boundsStale = false; // The only number is both bounds
+    } else if (!aggregate->boundsStale) {
+        aggregate->min = value < aggregate->min ? value : aggregate->min;
+        aggregate->max = value > aggregate->max ? value : aggregate->max;
+    }
+    aggregate->count++;
+    aggregate->sum += value;
+    aggregate->sumSquares += value * value;
+}
+
+// Function to remove a number from an aggregate
+void removeFromAggregate(runningAggregate *aggregate, double value) {
+    if (!aggregate || aggregate->count == 0) {
+        return;
+    }
+    aggregate->count--;
+    if (aggregate->count == 0) {
+        resetAggregate(aggregate); // Also drops the rounding left in the sums
+        return;
+    }
+    aggregate->sum -= value;
+    aggregate->sumSquares -= value * value;
+    if (value <= aggregate->min || value >= aggregate->max) {
+        aggregate->boundsStale = true; // The next bound is not known here
+    }
+}
+
+// Function to set recomputed bounds
+void setAggregateBounds(runningAggregate *aggregate, double min, double max) {
+    if (!aggregate) {
+        return;
+    }
+    aggregate->min = min;
+    aggregate->max = max;
+    aggregate->boundsStale = false;
+}
+
+// Function to get the mean of the numbers
+double aggregateMean(const runningAggregate *aggregate) {
+    if (!aggregate || aggregate->count == 0) {
+        return 0;
+    }
+    return aggregate->sum / aggregate->count;
+}
+
+// Function to get the variance of the numbers
+double aggregateVariance(const runningAggregate *aggregate) {
+    if (!aggregate || aggregate->count == 0) {
+        return 0;
+    }
+    double mean = aggregate->sum / aggregate->count;
+    double variance = aggregate->sumSquares / aggregate->count - mean * mean;
+    return variance > 0 ? variance : 0; // Rounding can make it slightly negative
+}
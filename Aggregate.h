@@ -0,0 +1,73 @@
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+#include "Defs.h"
+
+/**
+ * @file Aggregate.h
+ * @brief Running aggregates of a changing set of numbers.
+ *
+ * An aggregate keeps the count, sum and sum of squares of the numbers
+ * added and not yet removed, so their mean and variance are read in O(1).
+ * The minimum and maximum are kept too, but removing a number equal to
+ * one of them cannot restore the previous bound: the bounds are then only
+ * marked stale, and whoever owns the numbers recomputes them when they are
+ * next read (see setAggregateBounds).
+ */
+
+/**
+ * @struct runningAggregate
+ * The aggregate of a set of numbers.
+ */
+typedef struct {
+    long count; ///< Number of numbers
+    double sum; ///< Sum of the numbers
+    double sumSquares; ///< Sum of the squares of the numbers
+    double min; ///< Smallest number, valid when count > 0 and the bounds are not stale
+    double max; ///< Largest number, valid when count > 0 and the bounds are not stale
+    bool boundsStale; ///< Whether min and max must be recomputed before they are read
+} runningAggregate;
+
+/**
+ * @brief Empties an aggregate.
+ * @param aggregate The aggregate.
+ */
+void resetAggregate(runningAggregate *aggregate);
+
+/**
+ * @brief Adds a number to an aggregate, in O(1).
+ * @param aggregate The aggregate.
+ * @param value The number.
+ */
+void addToAggregate(runningAggregate *aggregate, double value);
+
+/**
+ * @brief Removes a number from an aggregate, in O(1). Removing one of the
+ * bounds marks the bounds stale, unless the aggregate becomes empty.
+ * @param aggregate The aggregate.
+ * @param value The number, which must have been added before.
+ */
+void removeFromAggregate(runningAggregate *aggregate, double value);
+
+/**
+ * @brief Sets recomputed bounds and clears the stale mark.
+ * @param aggregate The aggregate.
+ * @param min The smallest number.
+ * @param max The largest number.
+ */
+void setAggregateBounds(runningAggregate *aggregate, double min, double max);
+
+/**
+ * @brief Gets the mean of the numbers.
+ * @param aggregate The aggregate.
+ * @return The mean, or 0 if the aggregate is empty.
+ */
+double aggregateMean(const runningAggregate *aggregate);
+
+/**
+ * @brief Gets the (population) variance of the numbers.
+ * @param aggregate The aggregate.
+ * @return The variance, or 0 if the aggregate is empty.
+ */
+double aggregateVariance(const runningAggregate *aggregate);
+
+#endif //AGGREGATE_H
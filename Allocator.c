@@ -0,0 +1,37 @@
+#include "Allocator.h"
+
+// Function to allocate a block
+void *allocateBlock(const Allocator *allocator, size_t size) {
+    if (!allocator) {
+        return malloc(size);
+    }
+    return allocator->allocate(allocator->context, size);
+}
+
+// Function to release a block
+void releaseBlock(const Allocator *allocator, void *block, size_t size) {
+    if (!block) {
+        return;
+    }
+    if (!allocator) {
+        free(block);
+        return;
+    }
+    allocator->release(allocator->context, block, size);
+}
+
+// Function to move a block to a new size
+void *resizeBlock(const Allocator *allocator, void *block, size_t oldSize, size_t newSize) {
+    if (!allocator) {
+        return realloc(block, newSize);
+    }
+    void *resized = allocator->allocate(allocator->context, newSize);
+    if (!resized) {
+        return NULL;
+    }
+    if (block) {
+        memcpy(resized, block, oldSize < newSize ? oldSize : newSize);
+        allocator->release(allocator->context, block, oldSize);
+    }
+    return resized;
+}
@@ -0,0 +1,58 @@
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+#include "Defs.h"
+
+/**
+ * @file Allocator.h
+ * @brief A pluggable source of memory blocks for the containers and the Jerry records.
+ *
+ * A module that opts in allocates its blocks through an Allocator instead of
+ * malloc and free. Blocks are released with the size they were allocated
+ * with, so an allocator can keep per-size free lists without headers.
+ * A NULL allocator means plain malloc and free.
+ */
+
+/** A function allocating a block of a given size from an allocator's context. */
+typedef void *(*AllocateFunction)(void *context, size_t size);
+
+/** A function giving a block, and the size it was allocated with, back to an allocator's context. */
+typedef void (*ReleaseFunction)(void *context, void *block, size_t size);
+
+/**
+ * An allocator: its two functions and the context they work on.
+ * It must outlive every block allocated from it.
+ */
+typedef struct {
+    AllocateFunction allocate; ///< Allocates a block
+    ReleaseFunction release; ///< Releases a block
+    void *context; ///< The state of the allocator, passed to both functions
+} Allocator;
+
+/**
+ * @brief Allocates a block.
+ * @param allocator The allocator, or NULL for malloc.
+ * @param size The size of the block.
+ * @return The block, or NULL if the allocation failed.
+ */
+void *allocateBlock(const Allocator *allocator, size_t size);
+
+/**
+ * @brief Releases a block. Does nothing if the block is NULL.
+ * @param allocator The allocator the block came from, or NULL for free.
+ * @param block The block.
+ * @param size The size the block was allocated with.
+ */
+void releaseBlock(const Allocator *allocator, void *block, size_t size);
+
+/**
+ * @brief Moves a block to a new size, keeping its first bytes, like realloc.
+ * @param allocator The allocator the block came from, or NULL for realloc.
+ * @param block The block, or NULL to allocate a new one.
+ * @param oldSize The size the block was allocated with.
+ * @param newSize The new size.
+ * @return The resized block, or NULL if the allocation failed (the old block is then left as is).
+ */
+void *resizeBlock(const Allocator *allocator, void *block, size_t oldSize, size_t newSize);
+
+#endif //ALLOCATOR_H
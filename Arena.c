@@ -0,0 +1,145 @@
+#include <sys/mman.h>
+#include "Arena.h"
+
+// Blocks are aligned to, and sized in multiples of, this many bytes
+#define ALIGNMENT 16
+// Largest block kept on a free list when released
+#define LARGEST_CLASS 1024
+// Default size of the chunks mapped from the system
+#define DEFAULT_CHUNK (1 << 20)
+
+// Header at the start of every mapped chunk
+typedef struct chunk_s {
+    struct chunk_s *next; // Chunk mapped before this one
+    size_t size; // Size of the mapping
+} Chunk;
+
+// A released block, linked into the free list of its size class
+typedef struct freeBlock_s {
+    struct freeBlock_s *next; // Next released block of the same class
+} FreeBlock;
+
+// Arena structure: the chunks, the bump cursor, and the free lists
+typedef struct arena_s {
+    Chunk *chunks; // Every chunk mapped, newest first
+    char *cursor; // Next free byte of the chunk blocks are bumped from
+    char *limit; // End of that chunk
+    size_t chunkSize; // Size of the regular chunks
+    int chunkCount; // Number of chunks mapped
+    FreeBlock *freeLists[LARGEST_CLASS / ALIGNMENT + 1]; // Released blocks of each size class
+} Arena;
+
+// Round a size up to the alignment
+static size_t roundUp(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+}
+
+// Size of the chunk header, rounded so the first block is aligned
+static size_t headerSize(void) {
+    return roundUp(sizeof(Chunk));
+}
+
+// Map a chunk from the system and link it into the arena
+static Chunk *mapChunk(Arena *arena, size_t size) {
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return NULL;
+    }
+    Chunk *chunk = memory;
+    chunk->size = size;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->chunkCount++;
+    return chunk;
+}
+
+// Function to create an arena
+arena createArena(size_t chunkSize) {
+    Arena *arena = calloc(1, sizeof(Arena)); // Every free list starts empty
+    if (!arena) {
+        return NULL;
+    }
+    arena->chunkSize = chunkSize > headerSize() + LARGEST_CLASS ? chunkSize : DEFAULT_CHUNK;
+    return arena;
+}
+
+// Function to destroy an arena
+void destroyArena(arena arena) {
+    if (!arena) {
+        return;
+    }
+    Chunk *chunk = arena->chunks;
+    while (chunk) {
+        Chunk *next = chunk->next; // Read before the header is unmapped
+        munmap(chunk, chunk->size);
+        chunk = next;
+    }
+    free(arena);
+}
+
+// Function to allocate a block
+void *arenaAllocate(arena arena, size_t size) {
+    if (!arena) {
+        return NULL;
+    }
+    size = roundUp(size ? size : 1);
+    if (size <= LARGEST_CLASS) {
+        FreeBlock **list = &arena->freeLists[size / ALIGNMENT];
+        if (*list) {
+            FreeBlock *block = *list; // Reuse a released block of the same class
+            *list = block->next;
+            return block;
+        }
+    } else if (size > arena->chunkSize / 4) {
+        Chunk *chunk = mapChunk(arena, headerSize() + size); // A chunk of its own; the cursor stays where it is
+        if (!chunk) {
+            return NULL;
+        }
+        return (char *)chunk + headerSize();
+    }
+    if ((size_t)(arena->limit - arena->cursor) < size) {
+        Chunk *chunk = mapChunk(arena, arena->chunkSize);
+        if (!chunk) {
+            return NULL;
+        }
+        arena->cursor = (char *)chunk + headerSize(); // The rest of the previous chunk is abandoned
+        arena->limit = (char *)chunk + chunk->size;
+    }
+    void *block = arena->cursor;
+    arena->cursor += size;
+    return block;
+}
+
+// Function to release a block
+void arenaRelease(arena arena, void *block, size_t size) {
+    if (!arena || !block) {
+        return;
+    }
+    size = roundUp(size ? size : 1);
+    if (size > LARGEST_CLASS) {
+        return; // Reclaimed with the arena
+    }
+    FreeBlock *freed = block;
+    freed->next = arena->freeLists[size / ALIGNMENT];
+    arena->freeLists[size / ALIGNMENT] = freed;
+}
+
+// Adapters from the Allocator interface to the arena
+static void *allocateFromArena(void *context, size_t size) {
+    return arenaAllocate((Arena *)context, size);
+}
+
+static void releaseToArena(void *context, void *block, size_t size) {
+    arenaRelease((Arena *)context, block, size);
+}
+
+// Function to get an allocator drawing from an arena
+Allocator arenaAllocator(arena arena) {
+    Allocator allocator = {allocateFromArena, releaseToArena, arena};
+    return allocator;
+}
+
+// Function to get the number of chunks mapped so far
+int getArenaChunkCount(arena arena) {
+    return arena ? arena->chunkCount : 0;
+}
@@ -0,0 +1,66 @@
+
+#ifndef ARENA_H
+#define ARENA_H
+#include "Defs.h"
+#include "Allocator.h"
+
+/**
+ * @file Arena.h
+ * @brief A bump allocator for objects that live as long as the daycare.
+ *
+ * The arena maps large chunks from the system and hands out blocks by
+ * moving a cursor forward, so allocating costs a few instructions and
+ * no system call. Released blocks go to a free list of their size class
+ * (sizes rounded up to 16 bytes, up to 1024) and are reused by the next
+ * allocation of that class; larger blocks are only reclaimed when the
+ * arena is destroyed. Destroying the arena unmaps its chunks at once,
+ * whatever was still allocated from it.
+ */
+
+/** A type for an arena handle. */
+typedef struct arena_s *arena;
+
+/**
+ * @brief Creates an empty arena.
+ * @param chunkSize The size of the chunks mapped from the system, or 0 for 1 MiB.
+ * @return A handle to the new arena, or NULL if the allocation failed.
+ */
+arena createArena(size_t chunkSize);
+
+/**
+ * @brief Destroys an arena, unmapping every chunk. Every block allocated from it becomes invalid.
+ * @param arena The arena to destroy.
+ */
+void destroyArena(arena arena);
+
+/**
+ * @brief Allocates a block aligned to 16 bytes, reusing a released block of its size class when there is one.
+ * @param arena The arena.
+ * @param size The size of the block.
+ * @return The block, or NULL if the allocation failed.
+ */
+void *arenaAllocate(arena arena, size_t size);
+
+/**
+ * @brief Gives a block back to the free list of its size class.
+ * @param arena The arena the block came from.
+ * @param block The block.
+ * @param size The size the block was allocated with.
+ */
+void arenaRelease(arena arena, void *block, size_t size);
+
+/**
+ * @brief Gets an allocator drawing from an arena, to hand to the modules that accept one.
+ * @param arena The arena.
+ * @return The allocator. It stays valid as long as the arena does.
+ */
+Allocator arenaAllocator(arena arena);
+
+/**
+ * @brief Gets the number of chunks mapped from the system so far.
+ * @param arena The arena.
+ * @return The number of chunks, or 0 if the arena is NULL.
+ */
+int getArenaChunkCount(arena arena);
+
+#endif //ARENA_H
@@ -13,7 +13,14 @@ typedef Element(*CopyFunction) (Element);
 typedef status(*FreeFunction) (Element);
 typedef status(*PrintFunction) (Element);
 typedef int(*TransformIntoNumberFunction) (Element);
+typedef unsigned long long(*SeededHashFunction) (Element, unsigned long long);
 typedef bool(*EqualFunction) (Element, Element);
 
+/* Callbacks for containers that only refer to their elements:
+ * no copy, no free, and equality by address. */
+static inline Element borrowElement(Element element) { return element; }
+static inline status keepElement(Element element) { (void)element; return success; }
+static inline bool sameElement(Element element1, Element element2) { return element1 == element2; }
+
 
 #endif /* DEFS_H_ */
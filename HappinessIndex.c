@@ -0,0 +1,237 @@
+#include "HappinessIndex.h"
+#include "SimdKernels.h"
+
+// Happiness index structure: buckets by base level, and the composed activities mapping bases to levels
+typedef struct happiness_index_s {
+    linkedlist buckets[HAPPINESS_LEVELS]; // Jerries of each base level, in insertion order
+    int map[HAPPINESS_LEVELS]; // Current level of each base level
+    int preimage[HAPPINESS_LEVELS]; // A base level mapped to each level, -1 if there is none
+    linkedlist loose; // Jerries whose level no base maps to, in insertion order
+    jerry_store store; // Hot fields of the Jerries: happiness, base level and insertion number
+    unsigned long long seq; // Insertion number of the next Jerry
+    bool dirty; // Whether some happiness fields are behind the map
+} HappinessIndex;
+
+static status print_bucket_jerry(Element jerry) {
+    return print_jerry((Jerry *)jerry);
+}
+
+// Create an empty list that only refers to its Jerries
+static linkedlist create_bucket(void) {
+    return createLinkedList(borrowElement, keepElement, sameElement, print_bucket_jerry);
+}
+
+// Empty a list without touching the Jerries it refers to
+static void clear_bucket(linkedlist bucket) {
+    while (detachFirstNode(bucket) != NULL) {
+    }
+}
+
+// Recompute which base level each level can be filed under
+static void update_preimage(HappinessIndex *index) {
+    for (int i = 0; i < HAPPINESS_LEVELS; i++) {
+        index->preimage[i] = -1;
+    }
+    for (int b = 0; b < HAPPINESS_LEVELS; b++) {
+        if (index->preimage[index->map[b]] < 0) {
+            index->preimage[index->map[b]] = b;
+        }
+    }
+}
+
+// Forget every activity: each base level maps to itself again
+static void reset_map(HappinessIndex *index) {
+    for (int i = 0; i < HAPPINESS_LEVELS; i++) {
+        index->map[i] = i;
+    }
+    update_preimage(index);
+    index->dirty = false;
+}
+
+// The current level of a slot: through the map when filed in a bucket, as stored when loose
+static int level_of_slot(HappinessIndex *index, const int *base, const int *happiness, int slot) {
+    return base[slot] >= 0 ? index->map[base[slot]] : happiness[slot];
+}
+
+// Check whether a Jerry at some level is sadder than the saddest found so far
+static bool sadder(HappinessIndex *index, Jerry *jerry, int level, Jerry *saddest, int saddest_level) {
+    if (saddest == NULL || level < saddest_level) {
+        return true;
+    }
+    const unsigned long long *seq = mood_seq_column(index->store);
+    return level == saddest_level && seq[jerry->slot] < seq[saddest->slot]; // First inserted wins ties
+}
+
+// Create an empty happiness index over a Jerry store
+happiness_index create_happiness_index(jerry_store store) {
+    if (!store) {
+        return NULL;
+    }
+    HappinessIndex *index = calloc(1, sizeof(HappinessIndex)); // Every list starts NULL
+    if (!index) {
+        return NULL;
+    }
+    index->store = store;
+    index->loose = create_bucket();
+    bool created = index->loose != NULL;
+    for (int i = 0; i < HAPPINESS_LEVELS && created; i++) {
+        index->buckets[i] = create_bucket();
+        created = index->buckets[i] != NULL;
+    }
+    if (!created) {
+        destroy_happiness_index(index); // Free the lists created so far
+        return NULL;
+    }
+    index->seq = 0;
+    reset_map(index);
+    return index;
+}
+
+// Free a happiness index and its lists
+void destroy_happiness_index(happiness_index index) {
+    if (!index) {
+        return;
+    }
+    for (int i = 0; i < HAPPINESS_LEVELS; i++) {
+        if (index->buckets[i]) {
+            destroyList(index->buckets[i]);
+        }
+    }
+    if (index->loose) {
+        destroyList(index->loose);
+    }
+    free(index);
+}
+
+// Make every list of an empty happiness index allocate its nodes from an allocator
+status set_happiness_index_allocator(happiness_index index, const Allocator *allocator) {
+    if (!index || setListAllocator(index->loose, allocator) == failure) {
+        return failure;
+    }
+    for (int i = 0; i < HAPPINESS_LEVELS; i++) {
+        if (setListAllocator(index->buckets[i], allocator) == failure) {
+            return failure; // The index is not empty
+        }
+    }
+    return success;
+}
+
+// Add a Jerry at the end of a bucket mapped to its happiness, or to the loose list
+status add_to_happiness_index(happiness_index index, Jerry *jerry) {
+    if (!index || !jerry || jerry_in_slot(index->store, jerry->slot) != jerry) {
+        return failure;
+    }
+    int happiness = happiness_column(index->store)[jerry->slot];
+    int base = happiness >= 0 && happiness < HAPPINESS_LEVELS ? index->preimage[happiness] : -1;
+    jerry->mood = appendNodeWithHandle(base >= 0 ? index->buckets[base] : index->loose, jerry);
+    if (!jerry->mood) {
+        return failure;
+    }
+    mood_base_column(index->store)[jerry->slot] = base;
+    mood_seq_column(index->store)[jerry->slot] = index->seq++;
+    return success;
+}
+
+// Remove a Jerry from the list it was added to
+status remove_from_happiness_index(happiness_index index, Jerry *jerry) {
+    if (!index || !jerry || !jerry->mood || jerry_in_slot(index->store, jerry->slot) != jerry) {
+        return failure;
+    }
+    int base = mood_base_column(index->store)[jerry->slot];
+    linkedlist list = base >= 0 ? index->buckets[base] : index->loose;
+    if (removeNodeByHandle(list, jerry->mood) == failure) {
+        return failure;
+    }
+    jerry->mood = NULL;
+    return success;
+}
+
+// Apply an activity: compose it into the map, or file every Jerry again when some are loose
+status apply_happiness_activity(happiness_index index, linkedlist jerries, int above, int addabove, int decbelow) {
+    if (!index || !jerries) {
+        return failure;
+    }
+    if (getLengthList(index->loose) == 0) {
+        thresholdAddClamp(index->map, HAPPINESS_LEVELS, above, addabove, decbelow, 0, HAPPINESS_LEVELS - 1);
+        update_preimage(index);
+        index->dirty = true;
+        return success;
+    }
+    int *base = mood_base_column(index->store);
+    int *happiness = happiness_column(index->store);
+    int size = jerry_store_size(index->store);
+    for (int slot = 0; slot < size; slot++) { // Contiguous pass over the hot columns
+        happiness[slot] = level_of_slot(index, base, happiness, slot);
+    }
+    thresholdAddClamp(happiness, size, above, addabove, decbelow, 0, HAPPINESS_LEVELS - 1);
+    for (int i = 0; i < HAPPINESS_LEVELS; i++) {
+        clear_bucket(index->buckets[i]);
+    }
+    clear_bucket(index->loose);
+    reset_map(index); // Every level is in 0..100 now, so no Jerry stays loose
+    for (listNode node = listBegin(jerries); node != listEnd(jerries); node = listNext(node)) {
+        if (add_to_happiness_index(index, (Jerry *)borrowDataByNode(jerries, node)) == failure) {
+            return failure;
+        }
+    }
+    index->dirty = true; // The happiness fields still hold the levels before the activity
+    return success;
+}
+
+// Get the current happiness of a Jerry
+int happiness_of(happiness_index index, Jerry *jerry) {
+    if (!index || !jerry || !jerry->mood || jerry_in_slot(index->store, jerry->slot) != jerry) {
+        return jerry ? jerry->happiness : 0; // Unindexed: the field is up to date
+    }
+    return level_of_slot(index, mood_base_column(index->store), happiness_column(index->store), jerry->slot);
+}
+
+// Bring the happiness field of one Jerry up to date
+void sync_happiness(happiness_index index, Jerry *jerry) {
+    if (jerry) {
+        jerry->happiness = happiness_of(index, jerry);
+    }
+}
+
+// Bring the happiness field of every Jerry up to date
+void sync_all_happiness(happiness_index index) {
+    if (!index || !index->dirty) {
+        return;
+    }
+    const int *base = mood_base_column(index->store);
+    int *happiness = happiness_column(index->store);
+    int size = jerry_store_size(index->store);
+    for (int slot = 0; slot < size; slot++) {
+        happiness[slot] = level_of_slot(index, base, happiness, slot);
+        jerry_in_slot(index->store, slot)->happiness = happiness[slot]; // The only write to the cold table
+    }
+    index->dirty = false;
+}
+
+// Find the saddest Jerry: the first bucket head at the lowest level, or a sadder loose Jerry
+Jerry *saddest_in_happiness_index(happiness_index index) {
+    if (!index) {
+        return NULL;
+    }
+    Jerry *saddest = NULL;
+    int saddest_level = 0;
+    for (int b = 0; b < HAPPINESS_LEVELS; b++) {
+        linkedlist bucket = index->buckets[b];
+        if (getLengthList(bucket) > 0) {
+            Jerry *head = (Jerry *)borrowDataByNode(bucket, listBegin(bucket));
+            if (sadder(index, head, index->map[b], saddest, saddest_level)) {
+                saddest = head;
+                saddest_level = index->map[b];
+            }
+        }
+    }
+    const int *happiness = happiness_column(index->store);
+    for (listNode node = listBegin(index->loose); node != listEnd(index->loose); node = listNext(node)) {
+        Jerry *jerry = (Jerry *)borrowDataByNode(index->loose, node);
+        if (sadder(index, jerry, happiness[jerry->slot], saddest, saddest_level)) {
+            saddest = jerry;
+            saddest_level = happiness[jerry->slot];
+        }
+    }
+    return saddest;
+}
@@ -0,0 +1,119 @@
+
+#ifndef HAPPINESSINDEX_H
+#define HAPPINESSINDEX_H
+#include "Defs.h"
+#include "Jerry.h"
+#include "LinkedList.h"
+#include "JerryStore.h"
+
+/**
+ * @file HappinessIndex.h
+ * @brief A priority index of Jerries by happiness level, with lazy activities.
+ *
+ * Activities clamp happiness to 0..100, so the index holds one bucket per
+ * level, each listing its Jerries in insertion order. A bucket is keyed by
+ * the level its Jerries had when they were filed (their base), and a table
+ * of 101 entries maps each base to the current level: an activity is a pure
+ * function of the level, so applying one only composes it into that table,
+ * in 101 steps whatever the number of Jerries. The happiness field of a
+ * Jerry is only brought up to date when it is read through
+ * sync_happiness or sync_all_happiness.
+ *
+ * The saddest Jerry is the first of the bucket heads with the lowest
+ * current level, found in at most 101 steps; ties go to the Jerry inserted
+ * first. A Jerry whose level no base maps to (outside 0..100, or not reached
+ * by the composed activities) waits in a loose list with its happiness
+ * materialized; the next activity then files every Jerry again, in O(n).
+ * Each Jerry keeps its bucket node in its `mood` field; its base level,
+ * insertion number and last materialized happiness live in the columns of
+ * a Jerry store, so the O(n) passes run over contiguous memory.
+ */
+
+/** Number of happiness levels with a bucket of their own (0..100). */
+#define HAPPINESS_LEVELS 101
+
+/** A type for a happiness index handle. */
+typedef struct happiness_index_s *happiness_index;
+
+/**
+ * Creates a new, empty happiness index over a Jerry store.
+ * @param store The store holding every Jerry that will be added, which must outlive the index.
+ * @return A handle to the new index, or NULL if memory allocation fails.
+ */
+happiness_index create_happiness_index(jerry_store store);
+
+/**
+ * Frees a happiness index. The Jerries themselves are not freed.
+ * @param index The index to free.
+ */
+void destroy_happiness_index(happiness_index index);
+
+/**
+ * Makes the index allocate its list nodes from an allocator instead of malloc.
+ * Must be called while the index is empty.
+ * @param index The happiness index.
+ * @param allocator The allocator, which must outlive the index, or NULL for malloc.
+ * @return `success` if the allocator was set, otherwise `failure`.
+ */
+status set_happiness_index_allocator(happiness_index index, const Allocator *allocator);
+
+/**
+ * Adds a Jerry under its happiness, after every Jerry already in the index.
+ * The Jerry must already hold a slot of the index's store.
+ * @param index The happiness index.
+ * @param jerry The Jerry to add.
+ * @return `success` if the Jerry was added, otherwise `failure`.
+ */
+status add_to_happiness_index(happiness_index index, Jerry *jerry);
+
+/**
+ * Removes a Jerry from the index in constant time.
+ * @param index The happiness index.
+ * @param jerry The Jerry to remove.
+ * @return `success` if the Jerry was removed, otherwise `failure`.
+ */
+status remove_from_happiness_index(happiness_index index, Jerry *jerry);
+
+/**
+ * Applies an activity to every Jerry: those at or above the threshold gain
+ * addabove, the others lose decbelow, and the result is clamped to 0..100.
+ * Costs 101 steps, or O(n) when loose Jerries force every Jerry to be filed again.
+ * @param index The happiness index.
+ * @param jerries Every Jerry of the index, in insertion order, used to file them again.
+ * @param above Happiness threshold of the activity.
+ * @param addabove Happiness added to Jerries at or above the threshold.
+ * @param decbelow Happiness removed from Jerries below the threshold.
+ * @return `success` if the activity was applied, otherwise `failure`.
+ */
+status apply_happiness_activity(happiness_index index, linkedlist jerries, int above, int addabove, int decbelow);
+
+/**
+ * Gets the current happiness of an indexed Jerry, without updating its happiness field.
+ * @param index The happiness index.
+ * @param jerry The Jerry.
+ * @return The current happiness level.
+ */
+int happiness_of(happiness_index index, Jerry *jerry);
+
+/**
+ * Brings the happiness field of one Jerry up to date, in constant time.
+ * @param index The happiness index.
+ * @param jerry The Jerry to update.
+ */
+void sync_happiness(happiness_index index, Jerry *jerry);
+
+/**
+ * Brings the happiness field of every Jerry up to date. Free when no activity
+ * happened since the last call, O(n) otherwise.
+ * @param index The happiness index.
+ */
+void sync_all_happiness(happiness_index index);
+
+/**
+ * Finds the Jerry with the lowest current happiness; on ties, the one inserted first.
+ * @param index The happiness index.
+ * @return The saddest Jerry, or NULL if the index is empty.
+ */
+Jerry *saddest_in_happiness_index(happiness_index index);
+
+#endif //HAPPINESSINDEX_H
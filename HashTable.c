@@ -5,85 +5,427 @@
 #include "HashTable.h"
 #include "Defs.h"
 #include <stdio.h>
-#include "LinkedList.h"
 #include "KeyValuePair.h"
+#include <time.h>
+
+// Storage engines a hash table can be created with
+typedef enum e_engine { chainedEngine, robinHoodEngine } hashEngine;
+
+// Slot of the open addressing engine: the entry is stored inline in the array
+typedef struct {
+    Element key; // Key element, NULL when the slot is empty
+    Element value; // Value element
+    unsigned long long hash; // Full hash of the key, so probing rarely compares keys
+    int dist; // 1 + distance from the key's home slot, 0 marks an empty slot
+} Slot;
+
+// Number of buckets (or slot steps) moved from the old array on each operation while resizing
+#define MIGRATION_STEPS 4
 
 // HashTable structure definition
 typedef struct hashTable_s {
-    int size; // Size of the hash table (number of buckets)
-    linkedlist * hashTablearray; // Array of linked lists (buckets)
-    CopyFunction copykey; // Function to copy keys
-    FreeFunction freekey; // Function to free keys
-    PrintFunction printkey; // Function to print keys
-    PrintFunction printvalue; // Function to print values
-    CopyFunction copyvalue; // Function to copy values
-    FreeFunction freevalue; // Function to free values
-    EqualFunction equalkey; // Function to compare keys
-    EqualFunction equalkeyforlist; // Function to compare keys in linked list
-    TransformIntoNumberFunction transformIntoNumber; // Function to transform a key into a number (hash function)
+    hashEngine engine; // Storage engine chosen at creation time
+    int size; // Size of the hash table (number of buckets, or slots for the open addressing engine)
+    KeyValuePair * hashTablearray; // Array of bucket chains of key-value pairs, chained engine only
+    Slot * slots; // Flat array of slots (a power of two), open addressing engine only
+    KeyValuePair * oldarray; // Buckets still being moved by an incremental resize, NULL otherwise
+    Slot * oldslots; // Slots still being moved by an incremental resize, NULL otherwise
+    int oldsize; // Size of the array being moved
+    int migrated; // Next bucket (or slot) of the old array to move
+    int minsize; // The table never shrinks below its initial size
+    double maxload; // Load factor that triggers growth
+    double minload; // Load factor that triggers shrinking, 0 disables shrinking
+    int resizes; // Number of resizes started so far
+    PairTraits traits; // Functions handling keys and values, shared by every stored pair
+    CopyFunction keyOfValue; // Gives the key stored with a new value, NULL to store a copy of the passed key
+    TransformIntoNumberFunction transformIntoNumber; // Function to transform a key into a number (legacy hash function)
+    SeededHashFunction hashFunction; // Seeded 64 bit hash function, used when transformIntoNumber is NULL
+    unsigned long long seed; // Seed passed to hashFunction
+    int count; // Number of key-value pairs stored in the table
 }HashTable;
 
-// Helper function to return a copy of a key-value pair
-Element getCopypair(Element keyValuePair) {
-    if (!keyValuePair) return NULL; // Check if keyValuePair is NULL
-    KeyValuePair pair = (KeyValuePair)keyValuePair;
-    return pair;
+// Murmur3 64 bit finalizer: spreads every input bit over the whole word
+static unsigned long long mixBits(unsigned long long h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
 }
 
-// Helper function to destroy a key-value pair
-status destroyKeyValuePair1(Element pair){
-    if ( pair == NULL ) {
-        return failure; // Check if the pair is NULL
+// Multiply two words and fold the 128 bit product into 64 bits
+static unsigned long long mulFold(unsigned long long a, unsigned long long b) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+    return (unsigned long long)(r >> 64) ^ (unsigned long long)r;
+#else
+    return mixBits(a ^ mixBits(b));
+#endif
+}
+
+// FNV-1a string hash with the seed folded into the offset basis
+unsigned long long hashStringFNV1a(Element key, unsigned long long seed) {
+    if (!key) return 0;
+    const unsigned char *p = (const unsigned char *)key;
+    unsigned long long h = 14695981039346656037ULL ^ seed; // FNV offset basis
+    while (*p) {
+        h ^= *p++;
+        h *= 1099511628211ULL; // FNV prime
     }
-    KeyValuePair kvpair = (KeyValuePair)pair;
-    return destroyKeyValuePair(kvpair); // Use destroyKeyValuePair to free the pair
+    return mixBits(h); // FNV alone leaves the low bits weak for short keys
 }
 
-// Helper function to display a key-value pair
-status displaypair1(Element pair){
-    if ( pair == NULL ) {
-        return failure; // Check if the pair is NULL
+// Word-at-a-time seeded string hash in the style of wyhash
+unsigned long long hashStringWy(Element key, unsigned long long seed) {
+    if (!key) return 0;
+    const char *p = (const char *)key;
+    size_t len = strlen(p);
+    unsigned long long h = seed ^ 0xa0761d6478bd642fULL ^ mulFold(len, 0xe7037ed1a0b428dbULL);
+    while (len >= 8) {
+        unsigned long long w;
+        memcpy(&w, p, 8); // Unaligned-safe load of the next word
+        h = mulFold(h ^ w, 0x8ebc6af09c88c6e3ULL ^ seed);
+        p += 8;
+        len -= 8;
     }
-    KeyValuePair kv_pair = (KeyValuePair)pair;
-    return displaypair(kv_pair); // Use displaypair to print the pair
+    unsigned long long tail = 0;
+    memcpy(&tail, p, len); // Remaining 0-7 bytes
+    h = mulFold(h ^ tail, 0x589965cc75374cc3ULL ^ seed);
+    return mixBits(h);
+}
+
+// Build a per-process seed from the clock and the address space layout
+unsigned long long randomHashSeed(void) {
+    static int anchor;
+    unsigned long long seed = (unsigned long long)time(NULL);
+    seed ^= (unsigned long long)(size_t)&anchor << 16;
+    seed ^= (unsigned long long)clock();
+    return mixBits(seed);
 }
 
-// Helper function to compare a key-value pair with a key
-bool getKeycmp(Element pair, Element key){
-    if ( pair == NULL || key == NULL ) {
-        return false; // Check if the pair or key is NULL
+// Compute the full hash of a key using the table's hash strategy
+static unsigned long long hashKey(hashTable hashTable, Element key) {
+    if (hashTable->transformIntoNumber) {
+        return mixBits((unsigned int)hashTable->transformIntoNumber(key)); // Legacy int hash, treated as unsigned
     }
-    KeyValuePair kvpair = (KeyValuePair)pair;
-    return isEqualkey(kvpair, key); // Use isEqualkey to compare the key
+    return hashTable->hashFunction(key, hashTable->seed);
 }
 
-// Function to create a new hash table
-hashTable createHashTable(CopyFunction copyKey, FreeFunction freeKey, PrintFunction printKey, CopyFunction copyValue,
-                          FreeFunction freeValue, PrintFunction printValue, EqualFunction equalKey,
-                          TransformIntoNumberFunction transformIntoNumber, int hashNumber){
-    if (!copyKey || !freeKey || !printKey || !copyValue || !freeValue || !printValue || !equalKey || !transformIntoNumber || hashNumber <= 0) {
+/* ---------- Chained engine: an array of intrusive chains of key-value pairs ---------- */
+
+// Allocate an array of empty buckets
+static KeyValuePair *chainedArray(int size) {
+    KeyValuePair *array = malloc(sizeof(KeyValuePair) * size);
+    if (!array) {
+        return NULL; // Memory allocation failed
+    }
+    for (int i = 0; i < size; i++) {
+        array[i] = NULL; // Initialize buckets to NULL
+    }
+    return array;
+}
+
+// Find the pair of a key in a bucket array, comparing cached hashes before keys.
+// When prev is not NULL it receives the pair before it in the chain (NULL for the bucket head)
+static KeyValuePair chainedFind(hashTable hashTable, KeyValuePair *array, int size, Element key, unsigned long long hash,
+                                KeyValuePair *prev) {
+    KeyValuePair before = NULL;
+    for (KeyValuePair pair = array[hash % (unsigned long long)size]; pair != NULL; pair = getNextPair(pair)) {
+        if (getKeyHash(pair) == hash && isEqualkey(pair, key, &hashTable->traits)) {
+            if (prev) {
+                *prev = before;
+            }
+            return pair;
+        }
+        before = pair;
+    }
+    return NULL; // Key not found
+}
+
+// Push a pair onto the front of its bucket chain; the order inside a bucket is not significant
+static void chainedInsert(KeyValuePair *array, int size, KeyValuePair pair) {
+    int idx = (int)(getKeyHash(pair) % (unsigned long long)size);
+    setNextPair(pair, array[idx]);
+    array[idx] = pair;
+}
+
+// Remove the pair of a key from a bucket array
+static status chainedDelete(hashTable hashTable, KeyValuePair *array, int size, Element key, unsigned long long hash) {
+    KeyValuePair prev;
+    KeyValuePair pair = chainedFind(hashTable, array, size, key, hash, &prev);
+    if (pair == NULL) {
+        return failure; // Key not found
+    }
+    if (prev == NULL) {
+        array[hash % (unsigned long long)size] = getNextPair(pair); // Unlink the bucket head
+    } else {
+        setNextPair(prev, getNextPair(pair)); // Unlink from the middle of the chain
+    }
+    return destroyKeyValuePair(pair, &hashTable->traits);
+}
+
+// Destroy every chain of an array, and the array itself
+static void chainedFree(hashTable hashTable, KeyValuePair *array, int size) {
+    for (int i = 0; i < size; i++) {
+        KeyValuePair pair = array[i];
+        while (pair != NULL) {
+            KeyValuePair next = getNextPair(pair);
+            destroyKeyValuePair(pair, &hashTable->traits); // Destroy each pair of the chain
+            pair = next;
+        }
+    }
+    free(array); // Free the array of chains
+}
+
+// Move every pair of one old bucket into the current array, relinking the pairs in place
+static void chainedMigrateBucket(hashTable hashTable, int idx) {
+    KeyValuePair pair = hashTable->oldarray[idx];
+    while (pair != NULL) {
+        KeyValuePair next = getNextPair(pair);
+        chainedInsert(hashTable->hashTablearray, hashTable->size, pair); // No rehashing or allocation needed
+        pair = next;
+    }
+    hashTable->oldarray[idx] = NULL;
+}
+
+/* ---------- Open addressing engine: Robin Hood probing over a flat slot array ---------- */
+
+// Round a slot count up to a power of two, so probing can mask instead of divide
+static int roundUpPowerOfTwo(int n) {
+    int p = 8;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+// Place an entry known to be absent, starting at a slot where it is dist-1 steps from home,
+// robbing slots from entries closer to their home
+static void robinHoodPlaceAt(Slot *slots, int size, int idx, int dist, Slot entry) {
+    int mask = size - 1;
+    entry.dist = dist;
+    while (slots[idx].dist != 0) {
+        if (slots[idx].dist < entry.dist) {
+            Slot richer = slots[idx]; // The resident is closer to home, it moves on instead
+            slots[idx] = entry;
+            entry = richer;
+        }
+        idx = (idx + 1) & mask;
+        entry.dist++;
+    }
+    slots[idx] = entry;
+}
+
+// Place an entry known to be absent, starting from its home slot
+static void robinHoodPlace(Slot *slots, int size, Slot entry) {
+    robinHoodPlaceAt(slots, size, (int)(entry.hash & (size - 1)), 1, entry);
+}
+
+// Find the slot of a key, or -1 if it is absent; on a miss *insertAt and *insertDist
+// tell where the key belongs, so inserting it needs no second probe
+static int robinHoodProbe(hashTable hashTable, Slot *slots, int size, Element key, unsigned long long hash,
+                          int *insertAt, int *insertDist) {
+    int mask = size - 1;
+    int idx = (int)(hash & mask);
+    for (int dist = 1; ; dist++) {
+        Slot *slot = &slots[idx];
+        if (slot->dist < dist) {
+            *insertAt = idx; // An empty or richer slot: the key would have been placed here
+            *insertDist = dist;
+            return -1;
+        }
+        if (slot->hash == hash && hashTable->traits.compareKey(slot->key, key)) {
+            return idx;
+        }
+        idx = (idx + 1) & mask;
+    }
+}
+
+// Find the slot of a key, or -1 if it is absent
+static int robinHoodFind(hashTable hashTable, Slot *slots, int size, Element key, unsigned long long hash) {
+    int insertAt, insertDist;
+    return robinHoodProbe(hashTable, slots, size, key, hash, &insertAt, &insertDist);
+}
+
+// Empty a slot, shifting the entries displaced past it one step closer to home
+static void robinHoodShiftBack(Slot *slots, int size, int idx) {
+    int mask = size - 1;
+    int next = (idx + 1) & mask;
+    while (slots[next].dist > 1) {
+        slots[idx] = slots[next];
+        slots[idx].dist--;
+        idx = next;
+        next = (next + 1) & mask;
+    }
+    slots[idx].key = NULL;
+    slots[idx].value = NULL;
+    slots[idx].dist = 0;
+}
+
+// Free every stored entry of a slot array, and the array itself
+static void robinHoodFree(hashTable hashTable, Slot *slots, int size) {
+    for (int i = 0; i < size; i++) {
+        if (slots[i].dist != 0) {
+            hashTable->traits.destroyKey(slots[i].key); // Free each stored key and value
+            hashTable->traits.destroyValue(slots[i].value);
+        }
+    }
+    free(slots); // Free the slot array
+}
+
+/* ---------- Incremental resizing shared by both engines ---------- */
+
+// Move a few buckets (or slots) of the old array; free it once it is empty
+static void migrateSome(hashTable hashTable, int steps) {
+    if (!hashTable->oldarray && !hashTable->oldslots) {
+        return; // No resize in progress
+    }
+    while (steps-- > 0 && hashTable->migrated < hashTable->oldsize) {
+        if (hashTable->engine == chainedEngine) {
+            chainedMigrateBucket(hashTable, hashTable->migrated++);
+            continue;
+        }
+        Slot *slot = &hashTable->oldslots[hashTable->migrated];
+        if (slot->dist == 0) {
+            hashTable->migrated++; // Empty slot: move on
+            continue;
+        }
+        robinHoodPlace(hashTable->slots, hashTable->size, *slot);
+        robinHoodShiftBack(hashTable->oldslots, hashTable->oldsize, hashTable->migrated); // May refill this slot, so stay on it
+    }
+    if (hashTable->migrated >= hashTable->oldsize) {
+        free(hashTable->oldarray); // Every bucket has been moved
+        free(hashTable->oldslots);
+        hashTable->oldarray = NULL;
+        hashTable->oldslots = NULL;
+        hashTable->oldsize = 0;
+    }
+}
+
+// Start moving the table to an array of a new size; entries move over the next operations
+static status startResize(hashTable hashTable, int newSize) {
+    migrateSome(hashTable, 2 * hashTable->oldsize + 1); // Finish a resize still in progress
+    if (hashTable->engine == chainedEngine) {
+        KeyValuePair *array = chainedArray(newSize);
+        if (!array) {
+            return failure; // Memory allocation failed, keep the current array
+        }
+        hashTable->oldarray = hashTable->hashTablearray;
+        hashTable->hashTablearray = array;
+    } else {
+        Slot *slots = calloc(newSize, sizeof(Slot)); // dist 0 marks every slot empty
+        if (!slots) {
+            return failure; // Memory allocation failed, keep the current array
+        }
+        hashTable->oldslots = hashTable->slots;
+        hashTable->slots = slots;
+    }
+    hashTable->oldsize = hashTable->size;
+    hashTable->size = newSize;
+    hashTable->migrated = 0;
+    hashTable->resizes++;
+    return success;
+}
+
+// Grow before an insertion would push the load factor above the maximum
+static status growIfNeeded(hashTable hashTable) {
+    if (hashTable->count + 1 <= hashTable->maxload * hashTable->size) {
+        return success;
+    }
+    int newSize = hashTable->engine == chainedEngine ? hashTable->size * 2 + 1 : hashTable->size * 2;
+    if (startResize(hashTable, newSize) == failure) {
+        // A chained table keeps working above its load factor; open addressing needs a free slot
+        return hashTable->engine == chainedEngine || hashTable->count < hashTable->size - 1 ? success : failure;
+    }
+    return success;
+}
+
+// Shrink after a removal dropped the load factor below the minimum
+static void shrinkIfNeeded(hashTable hashTable) {
+    if (hashTable->minload <= 0 || hashTable->size / 2 < hashTable->minsize) {
+        return; // Shrinking disabled, or already at the initial size
+    }
+    if (hashTable->count < hashTable->minload * hashTable->size) {
+        startResize(hashTable, hashTable->size / 2); // On failure the table just stays larger
+    }
+}
+
+/* ---------- Public interface ---------- */
+
+// Fill in the fields shared by both engines
+static HashTable *allocHashTable(CopyFunction copyKey, FreeFunction freeKey, PrintFunction printKey, CopyFunction copyValue,
+                                 FreeFunction freeValue, PrintFunction printValue, EqualFunction equalKey,
+                                 TransformIntoNumberFunction transformIntoNumber, int hashNumber) {
+    if (!copyKey || !freeKey || !printKey || !copyValue || !freeValue || !printValue || !equalKey || hashNumber <= 0) {
         return NULL; // Validate input parameters
     }
     HashTable *newhashTable = malloc(sizeof(HashTable));
     if (!newhashTable) {
         return NULL; // Memory allocation failed
     }
+    newhashTable->traits.copyKey = copyKey;
+    newhashTable->traits.destroyKey = freeKey;
+    newhashTable->traits.printKey = printKey;
+    newhashTable->traits.copyValue = copyValue;
+    newhashTable->traits.destroyValue = freeValue;
+    newhashTable->traits.printValue = printValue;
+    newhashTable->traits.compareKey = equalKey;
+    newhashTable->traits.allocator = NULL;
+    newhashTable->keyOfValue = NULL;
+    newhashTable->transformIntoNumber = transformIntoNumber; // NULL selects the default string hash
+    newhashTable->hashFunction = hashStringFNV1a;
+    newhashTable->seed = 0;
+    newhashTable->count = 0;
+    newhashTable->hashTablearray = NULL;
+    newhashTable->slots = NULL;
+    newhashTable->oldarray = NULL;
+    newhashTable->oldslots = NULL;
+    newhashTable->oldsize = 0;
+    newhashTable->migrated = 0;
+    newhashTable->minload = 0;
+    newhashTable->resizes = 0;
+    return newhashTable;
+}
+
+// Function to create a new hash table
+hashTable createHashTable(CopyFunction copyKey, FreeFunction freeKey, PrintFunction printKey, CopyFunction copyValue,
+                          FreeFunction freeValue, PrintFunction printValue, EqualFunction equalKey,
+                          TransformIntoNumberFunction transformIntoNumber, int hashNumber){
+    HashTable *newhashTable = allocHashTable(copyKey, freeKey, printKey, copyValue, freeValue, printValue,
+                                             equalKey, transformIntoNumber, hashNumber);
+    if (!newhashTable) {
+        return NULL; // Invalid parameters or memory allocation failed
+    }
+    newhashTable->engine = chainedEngine;
     newhashTable->size = hashNumber;
-    newhashTable->copykey = copyKey;
-    newhashTable->freekey = freeKey;
-    newhashTable->printkey = printKey;
-    newhashTable->copyvalue = copyValue;
-    newhashTable->freevalue = freeValue;
-    newhashTable->printvalue = printValue;
-    newhashTable->equalkey = equalKey;
-    newhashTable->transformIntoNumber = transformIntoNumber;
-    newhashTable->hashTablearray = malloc(sizeof(linkedlist) * hashNumber);
+    newhashTable->minsize = hashNumber;
+    newhashTable->maxload = 1.0; // One pair per bucket on average
+    newhashTable->hashTablearray = chainedArray(hashNumber);
     if (!newhashTable->hashTablearray) {
         free(newhashTable); // Free allocated memory if allocation fails
         return NULL;
     }
-    for (int i = 0; i < hashNumber; i++) {
-        newhashTable->hashTablearray[i] = NULL; // Initialize buckets to NULL
+    return newhashTable;
+}
+
+// Function to create a new hash table backed by the open addressing engine
+hashTable createOpenHashTable(CopyFunction copyKey, FreeFunction freeKey, PrintFunction printKey, CopyFunction copyValue,
+                              FreeFunction freeValue, PrintFunction printValue, EqualFunction equalKey,
+                              TransformIntoNumberFunction transformIntoNumber, int hashNumber){
+    HashTable *newhashTable = allocHashTable(copyKey, freeKey, printKey, copyValue, freeValue, printValue,
+                                             equalKey, transformIntoNumber, hashNumber);
+    if (!newhashTable) {
+        return NULL; // Invalid parameters or memory allocation failed
+    }
+    newhashTable->engine = robinHoodEngine;
+    newhashTable->size = roundUpPowerOfTwo(hashNumber + hashNumber / 4 + 1); // Room for hashNumber keys below the max load
+    newhashTable->minsize = newhashTable->size;
+    newhashTable->maxload = 0.875; // Robin Hood probes stay short up to 7/8 full
+    newhashTable->slots = calloc(newhashTable->size, sizeof(Slot)); // dist 0 marks every slot empty
+    if (!newhashTable->slots) {
+        free(newhashTable); // Free allocated memory if allocation fails
+        return NULL;
     }
     return newhashTable;
 }
@@ -93,43 +435,148 @@ status destroyHashTable(hashTable hashTable){
     if (!hashTable) {
         return failure; // Check if the hash table is NULL
     }
-    for (int i = 0; i < hashTable->size; i++) {
-        if (hashTable->hashTablearray[i]) {
-            destroyList(hashTable->hashTablearray[i]); // Destroy each linked list
+    if (hashTable->engine == robinHoodEngine) {
+        robinHoodFree(hashTable, hashTable->slots, hashTable->size);
+        if (hashTable->oldslots) {
+            robinHoodFree(hashTable, hashTable->oldslots, hashTable->oldsize);
+        }
+    } else {
+        chainedFree(hashTable, hashTable->hashTablearray, hashTable->size);
+        if (hashTable->oldarray) {
+            chainedFree(hashTable, hashTable->oldarray, hashTable->oldsize);
         }
     }
-    free(hashTable->hashTablearray); // Free the array of linked lists
     free(hashTable); // Free the hash table structure
     return success;
 }
 
+// Find a key with a single probe, inserting it when absent. The value to insert is
+// made by makeValue(context) only on a miss, or is a copy of context when makeValue is NULL.
+// When stored is not NULL it receives the stored value itself (borrowed, not copied).
+static status findOrInsert(hashTable hashTable, Element key, CopyFunction makeValue, Element context,
+                           bool *inserted, Element *stored) {
+    *inserted = false;
+    migrateSome(hashTable, MIGRATION_STEPS);
+    unsigned long long hash = hashKey(hashTable, key); // Compute the hash once
+    int insertAt = 0, insertDist = 0;
+    if (hashTable->engine == robinHoodEngine) {
+        Slot *slots = hashTable->slots;
+        int idx = robinHoodProbe(hashTable, slots, hashTable->size, key, hash, &insertAt, &insertDist);
+        if (idx < 0 && hashTable->oldslots) {
+            slots = hashTable->oldslots; // Not moved yet
+            idx = robinHoodFind(hashTable, slots, hashTable->oldsize, key, hash);
+        }
+        if (idx >= 0) {
+            if (stored) {
+                *stored = slots[idx].value;
+            }
+            return success; // The key is already stored
+        }
+    } else {
+        KeyValuePair pair = chainedFind(hashTable, hashTable->hashTablearray, hashTable->size, key, hash, NULL);
+        if (pair == NULL && hashTable->oldarray) {
+            pair = chainedFind(hashTable, hashTable->oldarray, hashTable->oldsize, key, hash, NULL); // Not moved yet
+        }
+        if (pair != NULL) {
+            if (stored) {
+                *stored = borrowValue(pair);
+            }
+            return success; // The key is already stored
+        }
+    }
+
+    // The key is absent: grow only now, and re-probe if that moved the slots
+    Slot *probed = hashTable->slots;
+    if (growIfNeeded(hashTable) == failure) {
+        return failure;
+    }
+    if (hashTable->engine == robinHoodEngine && hashTable->slots != probed) {
+        robinHoodProbe(hashTable, hashTable->slots, hashTable->size, key, hash, &insertAt, &insertDist);
+    }
+    Element value = makeValue ? makeValue(context) : hashTable->traits.copyValue(context);
+    if (!value) {
+        return failure; // Value creation failed
+    }
+    if (hashTable->engine == robinHoodEngine) {
+        Slot entry;
+        entry.key = hashTable->traits.copyKey(hashTable->keyOfValue ? hashTable->keyOfValue(value) : key);
+        if (!entry.key) {
+            hashTable->traits.destroyValue(value); // Key copy failed
+            return failure;
+        }
+        entry.value = value;
+        entry.hash = hash;
+        robinHoodPlaceAt(hashTable->slots, hashTable->size, insertAt, insertDist, entry);
+    } else {
+        Element source = hashTable->keyOfValue ? hashTable->keyOfValue(value) : key;
+        KeyValuePair new = createKeyValuePair(source, value, &hashTable->traits, hash);
+        if (new == NULL) {
+            hashTable->traits.destroyValue(value); // Creation of key-value pair failed
+            return failure;
+        }
+        chainedInsert(hashTable->hashTablearray, hashTable->size, new);
+    }
+    hashTable->count++;
+    *inserted = true;
+    if (stored) {
+        *stored = value;
+    }
+    return success;
+}
+
 // Function to add a key-value pair to the hash table
 status addToHashTable(hashTable hashTable, Element key, Element value){
     if (!hashTable || !key || !value) {
         return failure; // Validate input
     }
-    KeyValuePair new = createKeyValuePair(key, value, hashTable->copykey, hashTable->copyvalue, hashTable->equalkey, hashTable->freekey, hashTable->freevalue, hashTable->printkey, hashTable->printvalue);
-    if (new == NULL) {
-        return failure; // Creation of key-value pair failed
+    bool inserted;
+    if (findOrInsert(hashTable, key, NULL, value, &inserted, NULL) == failure || !inserted) {
+        return failure; // Duplicate key or allocation failure
     }
-    int idx = hashTable->transformIntoNumber(key); // Compute the hash index
-    idx = idx % hashTable->size; // Ensure the index is within bounds
-    if (hashTable->hashTablearray[idx] == NULL) {
-        hashTable->hashTablearray[idx] = createLinkedList(getCopypair, destroyKeyValuePair1, getKeycmp, displaypair1); // Create a new linked list
-        if (!hashTable->hashTablearray[idx]) {
-            destroyKeyValuePair(new); // Cleanup if creation failed
-            return failure;
-        }
+    return success;
+}
+
+// Function to find a key, inserting it with a freshly made value if it is absent
+Element findOrInsertInHashTable(hashTable hashTable, Element key, CopyFunction makeValue, Element context, bool *inserted){
+    bool added = false;
+    Element value = NULL;
+    if (inserted) {
+        *inserted = false;
+    }
+    if (!hashTable || !key || !makeValue) {
+        return NULL; // Validate input
+    }
+    if (findOrInsert(hashTable, key, makeValue, context, &added, &value) == failure) {
+        return NULL; // Allocation failure
     }
-    if (searchByKeyInList(hashTable->hashTablearray[idx], key) == NULL) {
-        status add = appendNode(hashTable->hashTablearray[idx], new); // Add the key-value pair to the linked list
-        if (add == failure) {
-            destroyKeyValuePair(new); // Cleanup on failure
+    if (inserted) {
+        *inserted = added;
+    }
+    return value;
+}
+
+// Find the stored value of a key (borrowed, not copied), or NULL if it is absent
+static Element findValue(hashTable hashTable, Element key) {
+    migrateSome(hashTable, MIGRATION_STEPS);
+    unsigned long long hash = hashKey(hashTable, key); // Compute the hash index
+    if (hashTable->engine == robinHoodEngine) {
+        int slot = robinHoodFind(hashTable, hashTable->slots, hashTable->size, key, hash);
+        if (slot >= 0) {
+            return hashTable->slots[slot].value; // Return the value associated with the key
+        }
+        if (hashTable->oldslots) {
+            slot = robinHoodFind(hashTable, hashTable->oldslots, hashTable->oldsize, key, hash);
+            if (slot >= 0) {
+                return hashTable->oldslots[slot].value; // Not moved yet
+            }
         }
-        return add;
+        return NULL; // Key not found
+    }
+    KeyValuePair pair = chainedFind(hashTable, hashTable->hashTablearray, hashTable->size, key, hash, NULL);
+    if (pair == NULL && hashTable->oldarray) {
+        pair = chainedFind(hashTable, hashTable->oldarray, hashTable->oldsize, key, hash, NULL); // Not moved yet
     }
-    destroyKeyValuePair(new); // Cleanup duplicate key-value pair
-    return failure;
+    return borrowValue(pair); // NULL when the key was not found
 }
 
 // Function to lookup a value in the hash table by key
@@ -137,16 +584,19 @@ Element lookupInHashTable(hashTable hashTable, Element key){
     if (!hashTable || !key) {
         return NULL; // Validate input
     }
-    int idx = hashTable->transformIntoNumber(key); // Compute the hash index
-    idx = idx % hashTable->size; // Ensure the index is within bounds
-    if (hashTable->hashTablearray[idx] == NULL) {
-        return NULL; // Bucket is empty
-    }
-    Element val = searchByKeyInList(hashTable->hashTablearray[idx], key); // Search for the key in the bucket
-    if (val == NULL) {
+    Element value = findValue(hashTable, key);
+    if (value == NULL) {
         return NULL; // Key not found
     }
-    return getValue(val); // Return the value associated with the key
+    return hashTable->traits.copyValue(value); // Return a copy of the value associated with the key
+}
+
+// Function to lookup a value in the hash table by key without copying it
+Element borrowFromHashTable(hashTable hashTable, Element key){
+    if (!hashTable || !key) {
+        return NULL; // Validate input
+    }
+    return findValue(hashTable, key);
 }
 
 // Function to remove a key-value pair from the hash table
@@ -154,20 +604,29 @@ status removeFromHashTable(hashTable hashTable, Element key){
     if (!hashTable || !key) {
         return failure; // Validate input
     }
-    int idx = hashTable->transformIntoNumber(key); // Compute the hash index
-    idx = idx % hashTable->size; // Ensure the index is within bounds
-    if (hashTable->hashTablearray[idx] == NULL) {
-        return failure; // Bucket is empty
-    }
-    Element val = searchByKeyInList(hashTable->hashTablearray[idx], key); // Search for the key in the bucket
-    if (val == NULL) {
+    migrateSome(hashTable, MIGRATION_STEPS);
+    unsigned long long hash = hashKey(hashTable, key); // Compute the hash index
+    if (hashTable->engine == robinHoodEngine) {
+        Slot *slots = hashTable->slots;
+        int size = hashTable->size;
+        int idx = robinHoodFind(hashTable, slots, size, key, hash);
+        if (idx < 0 && hashTable->oldslots) {
+            slots = hashTable->oldslots; // Not moved yet
+            size = hashTable->oldsize;
+            idx = robinHoodFind(hashTable, slots, size, key, hash);
+        }
+        if (idx < 0) {
+            return failure; // Key not found
+        }
+        hashTable->traits.destroyKey(slots[idx].key);
+        hashTable->traits.destroyValue(slots[idx].value);
+        robinHoodShiftBack(slots, size, idx);
+    } else if (chainedDelete(hashTable, hashTable->hashTablearray, hashTable->size, key, hash) == failure &&
+               (!hashTable->oldarray || chainedDelete(hashTable, hashTable->oldarray, hashTable->oldsize, key, hash) == failure)) {
         return failure; // Key not found
     }
-    deleteNode(hashTable->hashTablearray[idx], key); // Remove the key-value pair
-    if (getLengthList(hashTable->hashTablearray[idx]) == 0) {
-        destroyList(hashTable->hashTablearray[idx]); // Destroy the bucket if empty
-        hashTable->hashTablearray[idx] = NULL;
-    }
+    hashTable->count--;
+    shrinkIfNeeded(hashTable);
     return success;
 }
 
@@ -176,12 +635,88 @@ status displayHashElements(hashTable hashTable){
     if (!hashTable) {
         return failure; // Validate input
     }
+    migrateSome(hashTable, 2 * hashTable->oldsize + 1); // Print from a single array
+    if (hashTable->engine == robinHoodEngine) {
+        for (int i = 0; i < hashTable->size; i++) {
+            if (hashTable->slots[i].dist != 0) {
+                hashTable->traits.printKey(hashTable->slots[i].key); // Print the key, then its value
+                hashTable->traits.printValue(hashTable->slots[i].value);
+            }
+        }
+        return success;
+    }
     for (int i = 0; i < hashTable->size; i++) {
-        if (hashTable->hashTablearray[i]) {
-            if (printList(hashTable->hashTablearray[i]) == failure) {
-                return failure; // Print each non-empty bucket
+        for (KeyValuePair pair = hashTable->hashTablearray[i]; pair != NULL; pair = getNextPair(pair)) {
+            if (displaypair(pair, &hashTable->traits) == failure) {
+                return failure; // Print each pair of each bucket
             }
         }
     }
     return success;
 }
+
+// Function to select the hash strategy of an empty hash table
+status setHashFunction(hashTable hashTable, SeededHashFunction hashFunction, unsigned long long seed) {
+    if (!hashTable || !hashFunction || hashTable->count > 0) {
+        return failure; // Existing keys would land in the wrong buckets
+    }
+    hashTable->transformIntoNumber = NULL;
+    hashTable->hashFunction = hashFunction;
+    hashTable->seed = seed;
+    return success;
+}
+
+// Function to make the table allocate its pairs from an allocator
+status setHashTableAllocator(hashTable hashTable, const Allocator *allocator) {
+    if (!hashTable || hashTable->count > 0) {
+        return failure; // Existing pairs came from the previous allocator
+    }
+    hashTable->traits.allocator = allocator;
+    return success;
+}
+
+// Function to make the table take the key of each new entry from its value
+status setKeyOfValue(hashTable hashTable, CopyFunction keyOfValue) {
+    if (!hashTable || hashTable->count > 0) {
+        return failure; // Existing keys were copied from the passed keys
+    }
+    hashTable->keyOfValue = keyOfValue;
+    return success;
+}
+
+// Function to configure when the hash table grows and shrinks
+status setLoadFactors(hashTable hashTable, double maxLoad, double minLoad) {
+    if (!hashTable || maxLoad <= 0 || minLoad < 0 || minLoad * 2 >= maxLoad) {
+        return failure; // Shrinking must leave the table below its maximum load
+    }
+    if (hashTable->engine == robinHoodEngine && maxLoad > 0.95) {
+        return failure; // Open addressing needs free slots to end its probes
+    }
+    hashTable->maxload = maxLoad;
+    hashTable->minload = minLoad;
+    return success;
+}
+
+// Function to get the current load factor of the hash table
+double getLoadFactor(hashTable hashTable) {
+    if (!hashTable) {
+        return 0;
+    }
+    return (double)hashTable->count / hashTable->size;
+}
+
+// Function to get the number of keys in the hash table
+int getHashTableCount(hashTable hashTable) {
+    if (!hashTable) {
+        return 0;
+    }
+    return hashTable->count;
+}
+
+// Function to get the number of resizes the hash table went through
+int getResizeCount(hashTable hashTable) {
+    if (!hashTable) {
+        return 0;
+    }
+    return hashTable->resizes;
+}
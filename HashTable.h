@@ -2,15 +2,71 @@
 #ifndef HASH_TABLE_H
 #define HASH_TABLE_H
 #include "Defs.h"
+#include "Allocator.h"
 
 typedef struct hashTable_s *hashTable;
 
 hashTable createHashTable(CopyFunction copyKey, FreeFunction freeKey, PrintFunction printKey, CopyFunction copyValue,
                           FreeFunction freeValue, PrintFunction printValue, EqualFunction equalKey, TransformIntoNumberFunction transformIntoNumber, int hashNumber);
+/* Same contract as createHashTable, but the table uses open addressing with
+ * Robin Hood probing: keys, values and hashes live inline in one flat array,
+ * so a lookup touches a few adjacent slots instead of chasing list nodes.
+ * hashNumber is the expected number of keys. */
+hashTable createOpenHashTable(CopyFunction copyKey, FreeFunction freeKey, PrintFunction printKey, CopyFunction copyValue,
+                              FreeFunction freeValue, PrintFunction printValue, EqualFunction equalKey, TransformIntoNumberFunction transformIntoNumber, int hashNumber);
 status destroyHashTable(hashTable);
 status addToHashTable(hashTable, Element key,Element value);
 Element lookupInHashTable(hashTable, Element key);
+/* Like lookupInHashTable, but the stored value itself is returned instead of a
+ * copy, so no copyValue call (and no allocation) happens on the read. The value
+ * is borrowed: it still belongs to the table, must not be freed, and is valid
+ * only until its key is removed or the table is destroyed. */
+Element borrowFromHashTable(hashTable, Element key);
+/* Single-probe find-or-insert: the key is hashed once and its bucket walked once.
+ * If the key is present its stored value is returned (borrowed, as by
+ * borrowFromHashTable) and *inserted is set to false. Otherwise makeValue(context)
+ * is called - only on this miss - and the table takes ownership of the value it
+ * returns (it is not copied); the key is copied, *inserted is set to true and the
+ * new value is returned, borrowed as well.
+ * Returns NULL if the arguments are invalid or an allocation failed. */
+Element findOrInsertInHashTable(hashTable, Element key, CopyFunction makeValue, Element context, bool *inserted);
 status removeFromHashTable(hashTable, Element key);
 status displayHashElements(hashTable);
 
+/* Hash strategies shipped with the library. Keys are treated as C strings.
+ * Both return a well mixed 64 bit hash; the seed changes the whole hash
+ * function, so a random seed makes bucket collisions hard to provoke. */
+unsigned long long hashStringFNV1a(Element key, unsigned long long seed); /* byte-at-a-time FNV-1a with a final avalanche */
+unsigned long long hashStringWy(Element key, unsigned long long seed); /* word-at-a-time multiply-mix (wyhash style), faster on long keys */
+unsigned long long randomHashSeed(void); /* a per-process seed for the seeded strategies */
+
+/* Selects the hash strategy of a table. Must be called while the table is empty.
+ * A table created with a NULL transformIntoNumber uses hashStringFNV1a with seed 0. */
+status setHashFunction(hashTable, SeededHashFunction hashFunction, unsigned long long seed);
+
+/* Makes a chained table allocate its key/value pairs from an allocator instead
+ * of malloc (open addressing tables store their pairs inline and ignore it).
+ * Must be called while the table is empty; the allocator must outlive the table.
+ * NULL goes back to malloc. */
+status setHashTableAllocator(hashTable, const Allocator *allocator);
+
+/* Makes the table store keyOfValue(value) as the key of each new entry, through
+ * copyKey, instead of the key passed to the insertion (which must still be equal
+ * to it). With copyKey and freeKey set to borrowElement and keepElement the table
+ * then keeps no key of its own: a value that holds its key is stored alone.
+ * Must be called while the table is empty. NULL goes back to copying the passed key. */
+status setKeyOfValue(hashTable, CopyFunction keyOfValue);
+
+/* Tables resize themselves: once an insertion would push the load factor
+ * (keys per bucket or slot) above maxLoad the array grows, and once a
+ * removal drops it below minLoad it shrinks (never below its initial size).
+ * The keys move incrementally, a few buckets per operation, so no single
+ * operation pays for the whole rehash. Defaults: maxLoad 1.0 for chained
+ * tables and 0.875 for open addressing, minLoad 0 (never shrink).
+ * minLoad must be less than half of maxLoad. */
+status setLoadFactors(hashTable, double maxLoad, double minLoad);
+double getLoadFactor(hashTable); /* current keys per bucket (or slot) */
+int getHashTableCount(hashTable); /* number of keys stored */
+int getResizeCount(hashTable); /* number of resizes started since creation */
+
 #endif /* HASH_TABLE_H */
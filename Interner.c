@@ -0,0 +1,130 @@
+#include "Interner.h"
+#include <stdint.h>
+#include "HashTable.h"
+
+// Number of strings the table starts with room for
+#define INITIAL_STRINGS 64
+
+static hashTable table = NULL; // Interned string -> its id, keys borrowed from the strings array
+static char **strings = NULL; // Interned strings, indexed by id
+static int count = 0; // Number of interned strings
+static int capacity = 0; // Number of entries allocated in strings
+static internerStats stats = {0}; // Counters reported by getInternerStats
+static const Allocator *allocator = NULL; // Source of the interned copies, NULL for malloc
+
+static status printString(Element string) {
+    printf("%s", (char *)string);
+    return success;
+}
+
+static status printId(Element id) {
+    printf("%ld", (long)(intptr_t)id - 1);
+    return success;
+}
+
+static bool sameString(Element string1, Element string2) {
+    return strcmp((char *)string1, (char *)string2) == 0;
+}
+
+// Create the table on the first interning: the keys are the interned copies and the values
+// their ids + 1 (never NULL), so the table copies and frees neither
+static status createInterner(void) {
+    table = createOpenHashTable(borrowElement, keepElement, printString, borrowElement, keepElement, printId, sameString,
+                                NULL, INITIAL_STRINGS);
+    return table ? success : failure;
+}
+
+// Function to get the id of a string, interning it if it is new
+int internString(const char *string) {
+    int id = findInternedString(string);
+    if (id >= 0) {
+        stats.requests++;
+        stats.bytesSaved += strlen(string) + 1; // The copy a caller would have made
+        return id;
+    }
+    if (!string) {
+        return -1;
+    }
+    if (!table && createInterner() == failure) {
+        return -1;
+    }
+    if (count == capacity) {
+        int grown = capacity ? capacity * 2 : INITIAL_STRINGS;
+        char **resized = realloc(strings, grown * sizeof(char *));
+        if (!resized) {
+            return -1;
+        }
+        strings = resized;
+        capacity = grown;
+    }
+    char *copy = allocateBlock(allocator, strlen(string) + 1);
+    if (!copy) {
+        return -1;
+    }
+    strcpy(copy, string);
+    if (addToHashTable(table, copy, (Element)(intptr_t)(count + 1)) == failure) {
+        releaseBlock(allocator, copy, strlen(copy) + 1);
+        return -1;
+    }
+    strings[count] = copy;
+    stats.strings++;
+    stats.bytes += strlen(copy) + 1;
+    stats.requests++;
+    return count++;
+}
+
+// Function to get the interned copy of a string, interning it if it is new
+const char *internedCopy(const char *string) {
+    return getInternedString(internString(string));
+}
+
+// Function to get the interned copy of a string without interning it
+const char *findInternedCopy(const char *string) {
+    return getInternedString(findInternedString(string));
+}
+
+// Function to get the id of a string without interning it
+int findInternedString(const char *string) {
+    if (!string || !table) {
+        return -1;
+    }
+    Element id = borrowFromHashTable(table, (Element)string);
+    return id ? (int)(intptr_t)id - 1 : -1;
+}
+
+// Function to get an interned string from its id
+const char *getInternedString(int id) {
+    if (id < 0 || id >= count) {
+        return NULL;
+    }
+    return strings[id];
+}
+
+// Function to get the counters of the interner
+internerStats getInternerStats(void) {
+    return stats;
+}
+
+// Function to make the interner allocate its copies from an allocator
+status setInternerAllocator(const Allocator *stringAllocator) {
+    if (count > 0) {
+        return failure; // Existing copies came from the previous allocator
+    }
+    allocator = stringAllocator;
+    return success;
+}
+
+// Function to free every interned string
+void destroyInterner(void) {
+    destroyHashTable(table); // The keys are freed with the strings array below
+    for (int i = 0; i < count; i++) {
+        releaseBlock(allocator, strings[i], strlen(strings[i]) + 1);
+    }
+    free(strings);
+    table = NULL;
+    strings = NULL;
+    count = 0;
+    capacity = 0;
+    stats = (internerStats){0};
+    allocator = NULL;
+}
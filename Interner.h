@@ -0,0 +1,86 @@
+
+#ifndef INTERNER_H
+#define INTERNER_H
+#include "Defs.h"
+#include "Allocator.h"
+
+/**
+ * @file Interner.h
+ * @brief A process-wide table giving each distinct string a stable small id.
+ *
+ * Interning a string stores one copy of it and returns its id; interning
+ * an equal string again returns the same id without copying anything, so
+ * strings that repeat across records can be kept and compared as ids.
+ * Ids count up from 0 in interning order and stay valid, together with
+ * the strings they name, until destroyInterner is called. The interned
+ * copies are stable too, so two interned strings are equal exactly when
+ * their pointers are.
+ */
+
+/**
+ * @struct internerStats
+ * Counters of the interner, from the first interning to destroyInterner.
+ */
+typedef struct {
+    int strings; ///< Number of distinct strings interned
+    size_t bytes; ///< Bytes held by the interned copies, terminators included
+    long requests; ///< Number of successful internString and internedCopy calls
+    size_t bytesSaved; ///< Bytes of the copies the requests for already interned strings would have made
+} internerStats;
+
+/**
+ * @brief Gets the id of a string, interning a copy of it if it is new.
+ * @param string The string.
+ * @return The id of the string, or -1 if the string is NULL or an allocation failed.
+ */
+int internString(const char *string);
+
+/**
+ * @brief Gets the interned copy of a string, interning it if it is new.
+ * @param string The string.
+ * @return The interned copy, shared by every equal string, or NULL if the
+ *         string is NULL or an allocation failed. It must not be freed.
+ */
+const char *internedCopy(const char *string);
+
+/**
+ * @brief Gets the interned copy of a string without interning it.
+ * @param string The string.
+ * @return The interned copy, or NULL if the string was never interned.
+ */
+const char *findInternedCopy(const char *string);
+
+/**
+ * @brief Gets the id of a string without interning it.
+ * @param string The string.
+ * @return The id of the string, or -1 if it was never interned.
+ */
+int findInternedString(const char *string);
+
+/**
+ * @brief Gets the interned copy of a string from its id.
+ * @param id The id.
+ * @return The string, or NULL if no string has this id.
+ */
+const char *getInternedString(int id);
+
+/**
+ * @brief Gets the counters of the interner.
+ * @return The counters, all 0 if nothing was interned.
+ */
+internerStats getInternerStats(void);
+
+/**
+ * @brief Makes the interner allocate its copies from an allocator instead of malloc.
+ * Must be called while nothing is interned; destroyInterner goes back to malloc.
+ * @param stringAllocator The allocator, which must outlive the interned strings, or NULL for malloc.
+ * @return Status of the operation (success or failure).
+ */
+status setInternerAllocator(const Allocator *stringAllocator);
+
+/**
+ * @brief Frees every interned string and resets the counters. Every id becomes invalid.
+ */
+void destroyInterner(void);
+
+#endif //INTERNER_H
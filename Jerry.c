@@ -1,66 +1,78 @@
 #include "Jerry.h"
 
+static const Allocator *jerry_allocator = NULL; // Source of every block of this module, NULL for malloc
+
+// Allocate a block for a record of this module
+static void *allocate(size_t size) {
+    return allocateBlock(jerry_allocator, size);
+}
+
+// Release a block of this module, with the size it was allocated with
+static void release(void *block, size_t size) {
+    releaseBlock(jerry_allocator, block, size);
+}
+
+// Copy a string into a block of this module
+static char *copy_string(const char *string) {
+    char *copy = allocate(strlen(string) + 1);
+    if (copy) {
+        strcpy(copy, string);
+    }
+    return copy;
+}
+
+// Make the module allocate its records from an allocator
+void set_jerry_allocator(const Allocator *allocator) {
+    jerry_allocator = allocator;
+}
+
 // Create a coordinate structure from given x, y, z values
 coord create_coord(float x, float y, float z) {
     coord new_coord = {x, y, z};
     return new_coord; // Return a new coordinate structure
 }
 
-// Create a physical characteristic
-PhysicalCharacteristics * create_physical_characteristics(char *pc_name, float val) {
-    if (!pc_name) { // Check for NULL inputs
+// Add a PhysicalCharacteristic to Jerry's array, leaving the inline room when it is full
+PhysicalCharacteristics *add_pc_to_jerry(Jerry *jerry, char *pc_name, float val) {
+    if (!jerry || !pc_name) {
         return NULL;
     }
-
-    // Allocate memory for a new PhysicalCharacteristic
-    PhysicalCharacteristics * new_pc = malloc(sizeof(PhysicalCharacteristics));
-    if (!new_pc) {
-        new_pc = NULL; // Explicitly set to NULL for clarity
-        return NULL; // Return failure if malloc fails
-    }
-
-    // Allocate memory for the name field
-    new_pc->name = malloc(strlen(pc_name) + 1);
-    if (!new_pc->name) {
-        free(new_pc); // Free the PhysicalCharacteristic if name allocation fails
-        new_pc = NULL;
+    int name_id = internString(pc_name);
+    if (name_id < 0) {
         return NULL;
     }
-
-    // Copy the name and set the value
-    strcpy(new_pc->name, pc_name);
-    new_pc->val = val;
-    return new_pc;
-}
-
-// Add a PhysicalCharacteristic to Jerry's list
-status add_pc_to_jerry(Jerry *jerry, PhysicalCharacteristics *new_pc) {
-    if (!new_pc) {
-        return failure;
-    }
-    // Reallocate memory for the array of PhysicalCharacteristics
-    PhysicalCharacteristics **new_pc_ptr = realloc(jerry->PhysicalCharacteristics,
-                                                    (jerry->pc_num + 1) * sizeof(PhysicalCharacteristics *));
-    if (!new_pc_ptr) {
-        free_physical_characteristics(new_pc); // Free the PhysicalCharacteristic
-        return failure; // Return failure if realloc fails
+    if (jerry->pc_num == jerry->pc_capacity) {
+        int capacity = jerry->pc_capacity * 2; // Geometric growth: the array is copied O(log n) times
+        PhysicalCharacteristics *grown;
+        if (jerry->PhysicalCharacteristics == jerry->inline_pcs) {
+            grown = allocate(capacity * sizeof(PhysicalCharacteristics));
+            if (grown) {
+                memcpy(grown, jerry->inline_pcs, jerry->pc_num * sizeof(PhysicalCharacteristics));
+            }
+        } else {
+            grown = resizeBlock(jerry_allocator, jerry->PhysicalCharacteristics,
+                                jerry->pc_capacity * sizeof(PhysicalCharacteristics),
+                                capacity * sizeof(PhysicalCharacteristics));
+        }
+        if (!grown) {
+            return NULL; // Memory allocation failed
+        }
+        jerry->PhysicalCharacteristics = grown;
+        jerry->pc_capacity = capacity;
     }
-
-    // Update Jerry's list of PhysicalCharacteristics
-    jerry->PhysicalCharacteristics = new_pc_ptr;
-    jerry->PhysicalCharacteristics[jerry->pc_num] = new_pc;
-    jerry->pc_num++;
-    return success;
+    PhysicalCharacteristics *pc = &jerry->PhysicalCharacteristics[jerry->pc_num++];
+    pc->name_id = name_id;
+    pc->val = val;
+    pc->entry = NULL;
+    return pc;
 }
 
-// Free memory allocated for a PhysicalCharacteristic
-void free_physical_characteristics(PhysicalCharacteristics *pc) {
-    if (!pc) return;
-    if (pc->name) {
-        free(pc->name); // Free the name field
-        pc->name = NULL;
+// Get the name of a PhysicalCharacteristic
+char *get_pc_name(PhysicalCharacteristics *pc) {
+    if (!pc) {
+        return NULL;
     }
-    free(pc); // Free the PhysicalCharacteristic structure
+    return (char *)getInternedString(pc->name_id);
 }
 
 // Create a new Planet structure
@@ -68,16 +80,15 @@ Planet *create_planet(char *pc_name , float x, float y, float z) {
     if (!pc_name) { // Check if the name is NULL
         return NULL;
     }
-    Planet *new_planet = malloc(sizeof(Planet));
+    Planet *new_planet = allocate(sizeof(Planet));
     if (!new_planet) {
         return NULL; // Return NULL if memory allocation fails
     }
-    new_planet->name = malloc(strlen(pc_name) + 1);
+    new_planet->name = internedCopy(pc_name);
     if (!new_planet->name) {
-        free(new_planet); // Free Planet structure if name allocation fails
+        release(new_planet, sizeof(Planet)); // Free Planet structure if name allocation fails
         return NULL;
     }
-    strcpy(new_planet->name, pc_name);
     new_planet->coord = create_coord(x, y, z); // Set the coordinates
     return new_planet;
 }
@@ -87,11 +98,7 @@ void free_planet(Planet *planet) {
     if (!planet) {
         return;
     }
-    if (planet->name) {
-        free(planet->name); // Free the name field
-        planet->name = NULL;
-    }
-    free(planet); // Free the Planet structure
+    release(planet, sizeof(Planet)); // Free the Planet structure, the name stays interned
 }
 
 // Create a new Origin structure
@@ -99,29 +106,24 @@ Origin *create_origin(Planet *planet, char *reality) {
     if (!planet || !reality) { // Check for NULL inputs
         return NULL;
     }
-    Origin *new_origin = malloc(sizeof(Origin));
+    Origin *new_origin = allocate(sizeof(Origin));
     if (!new_origin) {
         new_origin = NULL; // Explicitly set to NULL
         return new_origin;
     }
     new_origin->planet = planet;
-    new_origin->reality = malloc(strlen(reality) + 1);
+    new_origin->reality = internedCopy(reality); // Shared with every Jerry of this reality
     if (!new_origin->reality) {
-        free(new_origin); // Free Origin structure if reality allocation fails
+        release(new_origin, sizeof(Origin)); // Free Origin structure if reality allocation fails
         return NULL;
     }
-    strcpy(new_origin->reality, reality); // Set the reality field
     return new_origin;
 }
 
 // Free memory allocated for an Origin structure
 void free_origin(Origin *origin) {
     if (!origin) return;
-    if (origin->reality) {
-        free(origin->reality); // Free the reality field
-        origin->reality = NULL;
-    }
-    free(origin); // Free the Origin structure
+    release(origin, sizeof(Origin)); // Free the Origin structure, the reality stays interned
 }
 
 // Create a Jerry structure
@@ -133,101 +135,79 @@ Jerry *create_jerry(char *Id, char * reality, Planet *planet, int happiness) {
     if (!origin) {
       return NULL; // Return NULL if Origin creation fails
     }
-    Jerry *new_jerry = malloc(sizeof(Jerry));
+    Jerry *new_jerry = allocate(sizeof(Jerry));
     if (!new_jerry) {
-        new_jerry = NULL; // Explicitly set to NULL
-        return new_jerry;
+        free_origin(origin); // Free the Origin if Jerry allocation fails
+        return NULL;
     }
-    new_jerry->Id = malloc(strlen(Id) + 1);
+    new_jerry->Id = copy_string(Id);
     if (!new_jerry->Id) {
-        free(new_jerry); // Free Jerry structure if Id allocation fails
+        free_origin(origin);
+        release(new_jerry, sizeof(Jerry)); // Free Jerry structure if Id allocation fails
         return NULL;
     }
-    strcpy(new_jerry->Id, Id);
     new_jerry->origin = origin;
     new_jerry->happiness = happiness;
     new_jerry->pc_num = 0;
-    new_jerry->PhysicalCharacteristics = NULL;
+    new_jerry->pc_capacity = INLINE_PCS;
+    new_jerry->PhysicalCharacteristics = new_jerry->inline_pcs;
+    new_jerry->node = NULL;
+    new_jerry->mood = NULL;
+    new_jerry->planet_entry = NULL;
+    new_jerry->reality_entry = NULL;
+    new_jerry->slot = -1;
     return new_jerry;
 }
 
-// Free memory allocated for a PhysicalCharacteristic
-void free_pc(PhysicalCharacteristics *pc) {
-    if (!pc) return;
-    if (pc->name) {
-        free(pc->name); // Free the name field
-        pc->name = NULL;
-    }
-    free(pc); // Free the PhysicalCharacteristic structure
-}
-
 // Free memory allocated for a Jerry structure
 status free_jerry(Jerry *jerry) {
     if (!jerry) return failure;
 
     if (jerry->Id) {
-        free(jerry->Id); // Free the ID
+        release(jerry->Id, strlen(jerry->Id) + 1); // Free the ID
         jerry->Id = NULL;
     }
     if (jerry->origin) {
        free_origin(jerry->origin); // Free the Origin structure
     }
 
-    if (jerry->PhysicalCharacteristics) {
-        for (int i = 0; i < jerry->pc_num; i++) {
-            if (jerry->PhysicalCharacteristics[i]) {
-                free_pc(jerry->PhysicalCharacteristics[i]); // Free each PhysicalCharacteristic
-                jerry->PhysicalCharacteristics[i] = NULL;
-            }
-        }
-        free(jerry->PhysicalCharacteristics); // Free the array of PhysicalCharacteristics
-        jerry->PhysicalCharacteristics = NULL;
+    if (jerry->PhysicalCharacteristics != jerry->inline_pcs) {
+        release(jerry->PhysicalCharacteristics, jerry->pc_capacity * sizeof(PhysicalCharacteristics)); // Free the spilled array
+        jerry->PhysicalCharacteristics = jerry->inline_pcs;
     }
-    free(jerry); // Free the Jerry structure
+    release(jerry, sizeof(Jerry)); // Free the Jerry structure
     return success;
 }
 
 // Delete a PhysicalCharacteristic from Jerry
 status delete_pc_to_jerry(Jerry *jerry, char *pc_name) {
-    if (!jerry || !pc_name || !jerry->PhysicalCharacteristics) { // Check for NULL inputs
+    PhysicalCharacteristics *pc = get_pc_of_jerry(jerry, pc_name);
+    if (!pc) {
         return failure;
     }
-    for (int i = 0; i < jerry->pc_num; i++) {
-        if (strcmp(pc_name, jerry->PhysicalCharacteristics[i]->name) == 0) {
-            free_pc(jerry->PhysicalCharacteristics[i]); // Free the matching PhysicalCharacteristic
-            jerry->PhysicalCharacteristics[i] = NULL;
-            for (int j = i; j < jerry->pc_num - 1; j++) {
-                jerry->PhysicalCharacteristics[j] = jerry->PhysicalCharacteristics[j + 1]; // Shift elements
-            }
-            jerry->PhysicalCharacteristics[jerry->pc_num - 1] = NULL;
-            jerry->pc_num--;
-            if (jerry->pc_num == 0){
-                free(jerry->PhysicalCharacteristics); // Free the array if empty
-                jerry->PhysicalCharacteristics = NULL;
-                return success;
-            }
-            PhysicalCharacteristics **temp = realloc(jerry->PhysicalCharacteristics, jerry->pc_num * sizeof(PhysicalCharacteristics *));
-            if (!temp) { // Handle realloc failure
-                return failure;
-            }
-            jerry->PhysicalCharacteristics = temp; // Assign the new memory block
-            return success;
-        }
-    }
+    int i = (int)(pc - jerry->PhysicalCharacteristics);
+    memmove(pc, pc + 1, (jerry->pc_num - i - 1) * sizeof(PhysicalCharacteristics)); // Shift elements
+    jerry->pc_num--;
     return success;
 }
 
 // Check if a PhysicalCharacteristic exists in Jerry's list
 bool cheak_if_pc(Jerry *jerry, char *pc_name) {
-    if (!jerry || !pc_name || !jerry->PhysicalCharacteristics) { // Check for NULL inputs
-        return false;
+    return get_pc_of_jerry(jerry, pc_name) != NULL;
+}
+
+// Find a PhysicalCharacteristic in Jerry's list by name
+PhysicalCharacteristics *get_pc_of_jerry(Jerry *jerry, char *pc_name) {
+    if (!jerry || !pc_name) { // Check for NULL inputs
+        return NULL;
     }
-    for (int i = 0; i < jerry->pc_num; i++) {
-        if (strcmp(pc_name, jerry->PhysicalCharacteristics[i]->name) == 0) {
-            return true; // Return true if the characteristic exists
+    int name_id = findInternedString(pc_name);
+    for (int i = 0; i < jerry->pc_num && name_id >= 0; i++) {
+        if (jerry->PhysicalCharacteristics[i].name_id == name_id) { // Adjacent integers, no string compare
+            return &jerry->PhysicalCharacteristics[i];
         }
     }
-    return false;
+    return NULL;
 }
 
 // Print information about a Planet
@@ -246,8 +226,8 @@ status print_jerry(Jerry *jerry) {
     if (jerry->pc_num > 0) {
         printf("Jerry's physical Characteristics available : \n\t");
         for (int i = 0; i < jerry->pc_num; i++) {
-            printf("%s : %.2f ", jerry->PhysicalCharacteristics[i]->name,
-                   (float)jerry->PhysicalCharacteristics[i]->val);
+            printf("%s : %.2f ", get_pc_name(&jerry->PhysicalCharacteristics[i]),
+                   (float)jerry->PhysicalCharacteristics[i].val);
             if (i < jerry->pc_num - 1) {
                 printf(", ");
             }
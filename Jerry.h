@@ -5,6 +5,8 @@
 #ifndef JERRY_H
 #define JERRY_H
 #include "Defs.h"
+#include "Allocator.h"
+#include "Interner.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -36,7 +38,7 @@ coord create_coord(float x, float y, float z);
  * Represents a planet with a name and its spatial coordinates.
  */
 typedef struct {
-    char *name; ///< The name of the planet
+    const char *name; ///< The name of the planet, interned (see Interner.h)
     coord coord; ///< The planet's coordinates in 3D space
 } Planet;
 
@@ -46,18 +48,24 @@ typedef struct {
  */
 typedef struct {
     Planet *planet; ///< Pointer to the planet of origin
-    char *reality; ///< The reality of the Jerry (e.g., C-137)
+    const char *reality; ///< The reality of the Jerry (e.g., C-137), interned and shared by every Jerry of that reality
 } Origin;
 
 /**
  * @struct PhysicalCharacteristics
  * Represents a physical characteristic of a Jerry (e.g., height, weight).
+ * Characteristics are stored by value inside their Jerry, so a pointer to one
+ * is only valid until the Jerry's characteristics change.
  */
 typedef struct {
-    char *name; ///< The name of the characteristic (e.g., "Height")
+    int name_id; ///< Interned id of the name of the characteristic (e.g., "Height"), see Interner.h
     float val; ///< The value of the characteristic (e.g., 170.5 for height)
+    Element entry; ///< Handle of the Jerry's node in the list of Jerries sharing this characteristic
 } PhysicalCharacteristics;
 
+/** Number of characteristics a Jerry holds without any allocation. */
+#define INLINE_PCS 5
+
 /**
  * @struct Jerry
  * Represents a Jerry character with an ID, origin, physical characteristics, happiness level, and more.
@@ -65,18 +73,27 @@ typedef struct {
 typedef struct {
     char *Id; ///< Unique identifier for the Jerry
     Origin *origin; ///< Origin of the Jerry, including its planet and reality
-    PhysicalCharacteristics **PhysicalCharacteristics; ///< Array of physical characteristics
+    PhysicalCharacteristics *PhysicalCharacteristics; ///< Array of physical characteristics: inline_pcs, or a larger allocated array
     int pc_num; ///< Number of physical characteristics
+    int pc_capacity; ///< Number of characteristics the array has room for
+    PhysicalCharacteristics inline_pcs[INLINE_PCS]; ///< Room for the first characteristics
     int happiness; ///< Happiness level of the Jerry
+    Element node; ///< Handle of the Jerry's node in the daycare's insertion-order list
+    Element mood; ///< Handle of the Jerry's node in its happiness bucket
+    Element planet_entry; ///< Handle of the Jerry's entry in the index of Jerries by planet
+    Element reality_entry; ///< Handle of the Jerry's entry in the index of Jerries by reality
+    int slot; ///< Dense slot of the Jerry in the daycare's store of hot fields, -1 if none
 } Jerry;
 
 // Function Declarations
 
 /**
- * Frees a physical characteristic object.
- * @param pc Pointer to the PhysicalCharacteristics object to free.
+ * Makes every record of this module (planets, origins, Jerries, their IDs and characteristic
+ * arrays past the inline room) come from an allocator instead of malloc. Must be called
+ * before any of them is created; the allocator must outlive them all.
+ * @param allocator The allocator, or NULL for malloc.
  */
-void free_physical_characteristics(PhysicalCharacteristics *pc);
+void set_jerry_allocator(const Allocator *allocator);
 
 /**
  * Creates a new Planet with the given name and coordinates.
@@ -124,26 +141,29 @@ Jerry *create_jerry(char *Id, char *reality, Planet *planet, int happiness);
 status free_jerry(Jerry *jerry);
 
 /**
- * Frees a physical characteristic object.
- * @param pc Pointer to the PhysicalCharacteristics object to free.
+ * Adds a physical characteristic to a Jerry. The first INLINE_PCS are stored
+ * without allocating; past them the array grows geometrically.
+ * @param jerry Pointer to the Jerry to modify.
+ * @param pc_name The name of the physical characteristic (e.g., "Height"), interned. Must not be NULL.
+ * @param val The value of the physical characteristic (e.g., 180.5).
+ * @return Pointer to the stored characteristic, valid until the Jerry's characteristics change, or NULL if the operation failed.
  */
-void free_pc(PhysicalCharacteristics *pc);
+PhysicalCharacteristics *add_pc_to_jerry(Jerry *jerry, char *pc_name, float val);
 
 /**
- * Creates a new physical characteristic with the given name and value.
- * @param pc_name The name of the physical characteristic (e.g., "Height"). Must not be NULL.
- * @param val The value of the physical characteristic (e.g., 180.5).
- * @return Pointer to the newly created PhysicalCharacteristics structure, or NULL if memory allocation fails or input is invalid.
+ * Gets the name of a physical characteristic.
+ * @param pc Pointer to the characteristic.
+ * @return The interned name, or NULL if pc is NULL.
  */
-PhysicalCharacteristics *create_physical_characteristics(char *pc_name, float val);
+char *get_pc_name(PhysicalCharacteristics *pc);
 
 /**
- * Adds a physical characteristic to a Jerry.
- * @param jerry Pointer to the Jerry to modify.
- * @param physical_characteristics Pointer to the PhysicalCharacteristics to add.
- * @return `success` if the characteristic was added, otherwise `failure`.
+ * Finds a physical characteristic of a Jerry by name.
+ * @param jerry Pointer to the Jerry.
+ * @param pc_name Name of the characteristic to find.
+ * @return Pointer to the characteristic (owned by the Jerry, valid until its characteristics change), or NULL if the Jerry does not have it.
  */
-status add_pc_to_jerry(Jerry *jerry, PhysicalCharacteristics *physical_characteristics);
+PhysicalCharacteristics *get_pc_of_jerry(Jerry *jerry, char *pc_name);
 
 /**
  * Removes a physical characteristic from a Jerry.
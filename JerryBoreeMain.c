@@ -5,6 +5,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/stat.h>
 #include "Defs.h"
 #include "Jerry.h"
 #include "HashTable.h"
@@ -12,19 +15,38 @@
 #include "MultiValueHashTable.h"
 #include <math.h>
 #include "KeyValuePair.h"
+#include "HappinessIndex.h"
+#include "JerryStore.h"
+#include "Arena.h"
+#include "PlanetTree.h"
+#include "OriginIndex.h"
 
 /**
  * @struct PlanetList
  * Represents a list of planets, allowing dynamic storage and management of multiple planets.
+ * The planets keep their insertion order in the array, and a hash table indexes them by name.
  */
 
 typedef struct {
-    Planet **planets; ///< Array of pointers to Planet structs
+    Planet **planets; ///< Array of pointers to Planet structs, in insertion order
     int size; ///< Number of planets in the list
+    int capacity; ///< Number of pointers allocated in the array
+    hashTable by_name; ///< Interned planet name -> first planet with that name
+    planet_tree near; ///< k-d tree over the coordinates, built once every planet is loaded
 } PlanetList;
 
-// Create a list of planets
-PlanetList *create_planet_list() {
+static status print_planet_name(Element name) {
+    printf("%s", (char *)name);
+    return success;
+}
+
+static status print_planet_val(Element planet) {
+    print_planet((Planet *)planet);
+    return success;
+}
+
+// Create a list of planets, with room for the expected number of planets
+PlanetList *create_planet_list(int expected) {
     PlanetList *list = malloc(sizeof(PlanetList));
     if (!list) {
         list = NULL; // Explicitly set to NULL
@@ -32,25 +54,35 @@ PlanetList *create_planet_list() {
     }
     list->planets = NULL;
     list->size = 0;
+    list->capacity = 0;
+    list->near = NULL;
+    // The keys are the planets' interned names, equal exactly when their pointers are, and the values
+    // the planets owned by the array: the index copies and frees neither
+    list->by_name = createOpenHashTable(borrowElement, keepElement, print_planet_name, borrowElement, keepElement,
+                                        print_planet_val, sameElement, NULL, expected > 0 ? expected : 1);
+    if (!list->by_name) {
+        free(list);
+        return NULL;
+    }
+    setHashFunction(list->by_name, hashStringWy, randomHashSeed());
     return list;
 }
 
+// Find a planet by name, or NULL if there is none
+static Planet *find_planet(PlanetList *list, const char *name) {
+    const char *interned_name = findInternedCopy(name);
+    if (!interned_name) {
+        return NULL; // A name never interned is no planet's name
+    }
+    return (Planet *)borrowFromHashTable(list->by_name, (Element)interned_name);
+}
+
 // Check if a planet already exists in the list
 bool cheak_planet(PlanetList *list, Planet *planet) {
     if (!list || !planet) { // Check if inputs are NULL
         return false;
     }
-
-    if (list->size == 0) {
-        return false;
-    } else {
-        for (int i = 0; i < list->size; i++) {
-            if (strcmp(list->planets[i]->name, planet->name) == 0) {
-                return true; // Return true if the planet exists
-            }
-        }
-    }
-    return false;
+    return find_planet(list, planet->name) != NULL;
 }
 
 // Add a planet to the planet list
@@ -58,11 +90,19 @@ status add_to_planet_list(PlanetList *pl, Planet *planet) {
     if (!pl || !planet) { // Check for NULL inputs
         return failure;
     }
-    Planet **temp = realloc(pl->planets, (pl->size + 1) * sizeof(Planet *));
-    if (!temp) {
-        return failure; // Return failure if realloc fails
+    if (pl->size == pl->capacity) { // Grow geometrically, not by one slot per planet
+        int capacity = pl->capacity ? pl->capacity * 2 : 16;
+        Planet **temp = realloc(pl->planets, capacity * sizeof(Planet *));
+        if (!temp) {
+            return failure; // Return failure if realloc fails
+        }
+        pl->planets = temp;
+        pl->capacity = capacity;
+    }
+    // A repeated name keeps resolving to its first planet, as the old linear scan did
+    if (!cheak_planet(pl, planet) && addToHashTable(pl->by_name, (Element)planet->name, planet) == failure) {
+        return failure;
     }
-    pl->planets = temp;
     pl->planets[pl->size] = planet;
     pl->size++;
     return success;
@@ -72,6 +112,8 @@ status add_to_planet_list(PlanetList *pl, Planet *planet) {
 void free_planet_list(PlanetList *pl) {
     if (!pl) return; // If the PlanetList itself is NULL, nothing to free
 
+    destroyHashTable(pl->by_name); // The index borrows the planets and their names
+    destroy_planet_tree(pl->near);
     if (pl->planets) { // Check if the array of pointers is allocated
         for (int i = 0; i < pl->size; i++) {
             if (pl->planets[i]) { // Check if each planet is allocated
@@ -133,6 +175,18 @@ static bool is_valid2(char *input) {
     return false;
 }
 
+// Check if an input string is a valid option of the information menu (1-12)
+static bool is_valid3(char *input) {
+    if (strlen(input) == 0) return false;
+    char *valid[12] = {"1","2","3","4","5","6","7","8","9","10","11","12"};
+    for (int i = 0; i < 12; i++) {
+        if (strcmp(input, valid[i])==0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // Process and add a planet from an input line
 static status process_planet(PlanetList *planet_list, char *input_line) {
     if (!planet_list || !input_line){return failure;}
@@ -148,62 +202,126 @@ static status process_planet(PlanetList *planet_list, char *input_line) {
     return failure;
 }
 
-// Process and create a Jerry from an input line
-Jerry *process_jerry(hashTable jerrytable, PlanetList *planet_list, char *input_line, linkedlist alljerries) {
-    if (!planet_list || !input_line||!alljerries||!jerrytable) {return NULL;};
+/**
+ * @struct JerryDetails
+ * The details needed to create a Jerry, handed to the Jerry table so that
+ * the Jerry is only allocated when its ID is not taken yet.
+ */
+typedef struct {
+    char *id; ///< Unique identifier of the Jerry
+    char *reality; ///< The reality of the Jerry
+    Planet *planet; ///< The planet of origin
+    int happiness; ///< Initial happiness level
+} JerryDetails;
+
+// Create a Jerry from its details (called by the Jerry table on an ID miss)
+static Element build_jerry(Element details) {
+    JerryDetails *d = (JerryDetails *)details;
+    return create_jerry(d->id, d->reality, d->planet, d->happiness);
+}
+
+// Insert a new Jerry into the hash table with a single probe, or return NULL if the ID is taken
+static Jerry *insert_new_jerry(hashTable jerrytable, JerryDetails *details) {
+    bool inserted = false;
+    Jerry *jerry = (Jerry *)findOrInsertInHashTable(jerrytable, details->id, build_jerry, details, &inserted);
+    if (!jerry || !inserted) {
+        return NULL; // Allocation failure, or a Jerry with this ID already exists
+    }
+    return jerry;
+}
+
+// Split a Jerry line into its details, or fail if a field is missing or the planet is unknown
+static status parse_jerry(PlanetList *planet_list, char *input_line, JerryDetails *details) {
+    if (!planet_list || !input_line || !details) {return failure;}
     char *id = strtok(input_line, ","); // Extract Jerry ID
     char *reality = strtok(NULL, ","); // Extract reality
     char *planet_name = strtok(NULL, ","); // Extract planet name
-    int happiness = atoi(strtok(NULL, ",")); // Extract happiness level
-    if (!id || !reality || !planet_name) {return NULL;}
-    for (int i = 0; i < planet_list->size; i++) {
-        if (strcmp(planet_list->planets[i]->name, planet_name) == 0) {
-        Jerry *new_jerry = create_jerry(id, reality, planet_list->planets[i], happiness);
-        if (!new_jerry) {
+    char *happiness = strtok(NULL, ","); // Extract happiness level
+    if (!id || !reality || !planet_name || !happiness) {return failure;}
+    details->id = id;
+    details->reality = reality;
+    details->planet = find_planet(planet_list, planet_name);
+    details->happiness = atoi(happiness);
+    return details->planet ? success : failure;
+}
+
+// Create a parsed Jerry and add it to every structure, or undo it all
+static Jerry *index_jerry(hashTable jerrytable, JerryDetails *details, linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins) {
+    if (!jerrytable || !details || !alljerries || !happy || !store || !origins) {return NULL;}
+    char *id = details->id;
+    Jerry *new_jerry = insert_new_jerry(jerrytable, details);
+    if (!new_jerry) {
         return NULL;
-        }
-        status addjerry = addToHashTable(jerrytable , id , new_jerry);
-        if (addjerry == failure) {
-         free_jerry(new_jerry);
-         return NULL;}
-
-        addjerry = appendNode(alljerries, new_jerry);
-            if (addjerry == failure) {
-              removeFromHashTable(jerrytable,id);
-              return NULL;
-            }
-         return new_jerry;}}
- return NULL;
+    }
+    new_jerry->node = appendNodeWithHandle(alljerries, new_jerry);
+    if (new_jerry->node == NULL) {
+        removeFromHashTable(jerrytable,id);
+        return NULL;
+    }
+    if (add_to_jerry_store(store, new_jerry) == failure) {
+        removeNodeByHandle(alljerries, new_jerry->node);
+        removeFromHashTable(jerrytable,id);
+        return NULL;
+    }
+    if (add_to_happiness_index(happy, new_jerry) == failure) {
+        remove_from_jerry_store(store, new_jerry);
+        removeNodeByHandle(alljerries, new_jerry->node);
+        removeFromHashTable(jerrytable,id);
+        return NULL;
+    }
+    if (add_to_origin_index(origins, new_jerry) == failure) {
+        remove_from_happiness_index(happy, new_jerry);
+        remove_from_jerry_store(store, new_jerry);
+        removeNodeByHandle(alljerries, new_jerry->node);
+        removeFromHashTable(jerrytable,id);
+        return NULL;
+    }
+    return new_jerry;
+}
+
+// Process and create a Jerry from an input line
+Jerry *process_jerry(hashTable jerrytable, PlanetList *planet_list, char *input_line, linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins) {
+    JerryDetails details;
+    if (parse_jerry(planet_list, input_line, &details) == failure) {
+        return NULL;
+    }
+    return index_jerry(jerrytable, &details, alljerries, happy, store, origins);
 }
 
-// Process and add a physical characteristic to a Jerry
-static status process_pc(multiValueHashTable multihashpc, Jerry *jerry, char *input_line) {
-  if (!jerry || !input_line||!multihashpc) {
+// Split a characteristic line into its name and value
+static status parse_pc(char *input_line, char **pc_name, float *pc_val) {
+  if (!input_line || !pc_name || !pc_val) {
    return failure;
   }
   if (input_line[0] == '\t') { // Skip tab character if present
    input_line++;
   }
-
-  char *pc_name = strtok(input_line, ":"); // Extract characteristic name
+  *pc_name = strtok(input_line, ":"); // Extract characteristic name
   char *pc_value_str = strtok(NULL, ":"); // Extract characteristic value as string
-  float pc_val = atof(pc_value_str); // Convert value to float
-  PhysicalCharacteristics *new_pc = create_physical_characteristics(pc_name, pc_val); // Create new characteristic
-  if (!new_pc) {
+  if (!*pc_name || !pc_value_str) {
    return failure;
   }
-  status func = add_pc_to_jerry(jerry,new_pc); // Add the characteristic to Jerry
-  if (func == failure) { // Free memory if addition fails
-   free_physical_characteristics(new_pc);
+  *pc_val = atof(pc_value_str); // Convert value to float
+  return success;
+}
+
+// Add a parsed characteristic to a Jerry and the characteristics table
+static status index_pc(multiValueHashTable multihashpc, Jerry *jerry, char *pc_name, float pc_val) {
+  if (!jerry || !pc_name || !multihashpc) {
    return failure;
   }
-  status pc = addToMultiValueHashTable(multihashpc, pc_name, jerry);
-  if (pc == failure) {
-    free_physical_characteristics(new_pc);
+  PhysicalCharacteristics *new_pc = add_pc_to_jerry(jerry, pc_name, pc_val); // Add the characteristic to Jerry
+  if (!new_pc) {
+   return failure;
+  }
+  new_pc->entry = addToMultiValueHashTableWithHandle(multihashpc, pc_name, jerry);
+  if (new_pc->entry == NULL) {
+    delete_pc_to_jerry(jerry, pc_name);
     return failure;
  }
  return success;
 }
+
 // Copy a Jerry element without creating a deep copy
 Element copyJerryVal(Element jerry) {
   if (!jerry) {
@@ -235,6 +353,14 @@ status free_str_Key(Element str) {
   return success;
 }
 
+// Intern a characteristic name key, shared with the Jerries' characteristics
+Element copyInternedKey(Element str) {
+  if (!str){
+    return NULL;
+  }
+  return (Element)internedCopy((char *)str);
+}
+
 // Print a string key (currently commented out)
 status print_str_key(Element str) {
   if (!str){
@@ -267,36 +393,29 @@ bool key_cmp(Element str1, Element str2) {
   if (!str1 || !str2){
     return false;
   }
+  if (str1 == str2) { // Interned keys
+    return true;
+  }
   if (strcmp((char *)str1, (char *)str2) == 0) {
     return true;
   }
   return false;
 }
 
-// Convert a Jerry ID to a numeric value
-int jerry2num(Element id) {
-  if (!id){
-    return 0;
-  }
-  int sum = 0;
-  char *copy = (char *)id;
-  for (int i = 0; i < strlen(copy); i++) {
-    char ch = copy[i];
-    if (isalpha(ch)) {
-      sum += (int)ch;
-    } else if (isdigit(ch)) {
-      sum += ch - '0';
-    }
-  }
-  return sum;
+// The key of a Jerry in the Jerry table: its own ID
+static Element jerry_id_key(Element jerry) {
+  return (Element)getjerryid((Jerry *)jerry);
 }
 
-// Create a hash table for storing Jerries
+// Create a hash table for storing Jerries (open addressing, every menu option starts with an ID lookup)
 hashTable createHashJerry(int size){
-  hashTable jerrrytable = createHashTable(copyKey, free_str_Key, print_str_key, copyJerryVal, free_jerry_val, print_jerry_val, key_cmp, jerry2num, size);
+  hashTable jerrrytable = createOpenHashTable(borrowElement, keepElement, print_str_key, copyJerryVal, free_jerry_val, print_jerry_val, key_cmp, NULL, size);
   if (!jerrrytable) {
     return NULL;
   }
+  setKeyOfValue(jerrrytable, jerry_id_key); // The table borrows each Jerry's ID instead of copying it
+  // IDs are structured (prefix + number), use the seeded word-at-a-time hash
+  setHashFunction(jerrrytable, hashStringWy, randomHashSeed());
   return jerrrytable;
 }
 
@@ -318,51 +437,88 @@ status NOTfreejerrys(Element jerry) {
   return success;
 }
 
+// Score a Jerry under a characteristic name: the value of that characteristic
+static double pc_score(Element pc_name, Element jerry) {
+  PhysicalCharacteristics *pc = get_pc_of_jerry((Jerry *)jerry, (char *)pc_name);
+  if (!pc) {
+    return 0;
+  }
+  return pc->val;
+}
+
 // Create a MultiValueHashTable for storing physical characteristics
 multiValueHashTable createMultiValueHashTablePC(int size){
-  multiValueHashTable hashPC = createMultiValueHashTable(copyKey, free_str_Key, print_str_key, copyJerryVal, NOTfreejerrys, print_jerry_val, key_cmp, jerry2num, size, equaljerrys);
+  multiValueHashTable hashPC = createMultiValueHashTable(copyInternedKey, keepElement, print_str_key, copyJerryVal, NOTfreejerrys, print_jerry_val, key_cmp, NULL, size, equaljerrys);
   if (!hashPC) {
     return NULL;
   }
+  setMultiValueScoreFunction(hashPC, pc_score); // Keep each characteristic's Jerries ordered by value
   return hashPC;
 }
 
-// Count the number of Jerries and physical characteristics in a file
-status count_elements_infile(const char *filename, int *countjerrys, int *countpc) {
-  FILE *file = fopen(filename, "r");
-  if (!file) {
-    return failure;
+// Bytes a Jerry takes in a data file with its characteristics, on the short side:
+// a table sized from it may have to grow while loading, but is never much too large
+#define BYTES_PER_JERRY 64
+
+// Distinct characteristic names expected; the table grows if there are more
+#define EXPECTED_PC_NAMES 61
+
+// Estimate the number of Jerries in a file from its size, without reading it
+static int estimate_jerries_infile(const char *filename) {
+  struct stat info;
+  if (stat(filename, &info) != 0 || info.st_size <= 0) {
+    return 0;
   }
+  long long estimate = info.st_size / BYTES_PER_JERRY;
+  return estimate < INT_MAX / 2 ? (int)estimate : INT_MAX / 2;
+}
 
-  char line[301];
-  *countjerrys = 0;
-  *countpc = 0;
-  bool jerrys = false;
-
-  while (fgets(line, sizeof(line), file)) {
-    line[strcspn(line, "\n")] = '\0';
-    if (strcmp(line, "Jerries") == 0) {
-      jerrys = true;
-      continue;
-    }
-    if (jerrys) {
-      if (strchr(line, ':') == NULL) {
-        (*countjerrys)++;
-      } else {
-        (*countpc)++;
-      }
-    }
+/**
+ * @struct LoadTimings
+ * Where the time of loading a data file goes, in seconds.
+ */
+typedef struct {
+  bool enabled; ///< Whether the phases are timed at all; if not, the clock is never read
+  struct timespec mark; ///< End of the last timed phase
+  double read; ///< Reading lines from the file
+  double parse; ///< Splitting lines into fields
+  double index; ///< Creating the planets, Jerries and characteristics and adding them to every structure
+} LoadTimings;
+
+// Start timing from now, if timing is enabled
+static void start_phases(LoadTimings *timings) {
+  if (timings->enabled) {
+    clock_gettime(CLOCK_MONOTONIC, &timings->mark);
   }
+}
 
-  fclose(file);
-  return success;
+// Add the time since the mark to a phase and move the mark to now, if timing is enabled
+static void end_phase(LoadTimings *timings, double *phase) {
+  if (!timings->enabled) {
+    return;
+  }
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  *phase += (now.tv_sec - timings->mark.tv_sec) + (now.tv_nsec - timings->mark.tv_nsec) / 1e9;
+  timings->mark = now;
+}
+
+// Read the next line of a file into a buffer without its newline, timed as reading
+static bool read_line(char *line, int size, FILE *file, LoadTimings *timings) {
+  bool read = fgets(line, size, file) != NULL;
+  if (read) {
+    line[strcspn(line, "\n")] = '\0'; // Remove trailing newline
+  }
+  end_phase(timings, &timings->read);
+  return read;
 }
 
-// Load data from a file into the data structures
-static status load_file(char *filename, PlanetList **planetList, hashTable JerrysHashTable, int num_of_planets, multiValueHashTable PC_MultiHashTable, linkedlist alljerries ) {
-  if (!alljerries || !JerrysHashTable || !PC_MultiHashTable) {
+// Load data from a file into the data structures, in a single pass
+static status load_file(char *filename, PlanetList **planetList, hashTable JerrysHashTable, int num_of_planets, multiValueHashTable PC_MultiHashTable, linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins, LoadTimings *timings) {
+  if (!alljerries || !JerrysHashTable || !PC_MultiHashTable || !timings) {
     return failure;
   }
+  start_phases(timings);
   FILE *file = fopen(filename, "r"); // Open file
   if (!file) {
     printf(" A memory problem has been detected in the program");
@@ -370,8 +526,9 @@ static status load_file(char *filename, PlanetList **planetList, hashTable Jerry
   }
 
   // Initialize the lists and counters
-  *planetList = create_planet_list(); // Initialize planet list
+  *planetList = create_planet_list(num_of_planets); // Initialize planet list
   if (!(*planetList)) {
+    fclose(file);
     return failure;
   }
 
@@ -379,32 +536,35 @@ static status load_file(char *filename, PlanetList **planetList, hashTable Jerry
   status op_status = success; // Variable to track the status of operations
 
   // Read lines from the file while there are no errors and lines are available
-  while (op_status == success && fgets(line, sizeof(line), file)) {
-    line[strcspn(line, "\n")] = '\0'; // Remove trailing newline
-
+  while (op_status == success && read_line(line, sizeof(line), file, timings)) {
     if (strcmp(line, "Planets") == 0) { // Process planets
       if (num_of_planets == 0) { // Check if there are any planets to process
         break; // Exit if no planets need to be processed
       }
       for (int i = 0; i < num_of_planets; i++) {
-        if (!fgets(line, sizeof(line), file)) { // Read the next line for planet data
+        if (!read_line(line, sizeof(line), file, timings)) { // Read the next line for planet data
           op_status = failure;
           break;
         }
-        line[strcspn(line, "\n")] = '\0'; // Remove the trailing newline
         op_status = process_planet(*planetList, line); // Process the planet and add it to the list
+        end_phase(timings, &timings->index); // Too short to split: a planet is parsed while it is created
         if (op_status == failure) break;
       }
     }
-    fgets(line, sizeof(line), file);
-    line[strcspn(line, "\n")] = '\0';
+    read_line(line, sizeof(line), file, timings);
     if (strcmp(line, "Jerries") == 0 && op_status == success) {
       Jerry *current_jerry = NULL;
-      while (fgets(line, sizeof(line), file)) {
-        line[strcspn(line, "\n")] = '\0';
+      while (read_line(line, sizeof(line), file, timings)) {
         if (strchr(line, ':') != NULL) {
           if (current_jerry) {
-            op_status = process_pc(PC_MultiHashTable, current_jerry, line);
+            char *pc_name = NULL;
+            float pc_val = 0;
+            op_status = parse_pc(line, &pc_name, &pc_val);
+            end_phase(timings, &timings->parse);
+            if (op_status == success) {
+              op_status = index_pc(PC_MultiHashTable, current_jerry, pc_name, pc_val);
+              end_phase(timings, &timings->index);
+            }
             if (op_status == failure) break;
           } else {
             printf(" A memory problem has been detected in the program \n");
@@ -412,7 +572,11 @@ static status load_file(char *filename, PlanetList **planetList, hashTable Jerry
             break;
           }
         } else if (strchr(line, ',') != NULL) {
-          current_jerry = process_jerry(JerrysHashTable, *planetList, line, alljerries);
+          JerryDetails details;
+          bool parsed = parse_jerry(*planetList, line, &details) == success;
+          end_phase(timings, &timings->parse);
+          current_jerry = parsed ? index_jerry(JerrysHashTable, &details, alljerries, happy, store, origins) : NULL;
+          end_phase(timings, &timings->index);
           if (!current_jerry) {
             printf(" A memory problem has been detected in the program \n");
             op_status = failure;
@@ -424,6 +588,7 @@ static status load_file(char *filename, PlanetList **planetList, hashTable Jerry
     fclose(file);
     return op_status;
   }
+  fclose(file);
   return op_status;
 }
 
@@ -432,7 +597,7 @@ Jerry *jerrybyid(hashTable hashjerry, char *key) {
   if (!hashjerry || !key) {
     return NULL;
   }
-  return (Jerry *)(lookupInHashTable(hashjerry, key));
+  return (Jerry *)(borrowFromHashTable(hashjerry, key));
 }
 
 // Add a physical characteristic to a Jerry and update the MultiValueHashTable
@@ -440,20 +605,13 @@ status addpctojerryhash(multiValueHashTable multihashpc, Jerry *jerry, char *key
     if (!jerry || !key || !multihashpc) {
         return failure;
     }
-    PhysicalCharacteristics *pc = create_physical_characteristics(key, pcval);
+    PhysicalCharacteristics *pc = add_pc_to_jerry(jerry, key, pcval); // First, so the table can read the value it orders by
     if (!pc) {
         return failure;
     }
-    status s = addToMultiValueHashTable(multihashpc, key, jerry);
-    if (s == failure) {
-        free_pc(pc);
-        return failure;
-    }
-
-    s = add_pc_to_jerry(jerry, pc);
-    if (s == failure) {
-        free_physical_characteristics(pc);
-        removeFromMultiValueHashTable(multihashpc, key, jerry);
+    pc->entry = addToMultiValueHashTableWithHandle(multihashpc, key, jerry);
+    if (pc->entry == NULL) {
+        delete_pc_to_jerry(jerry, key);
         return failure;
     }
     return success;
@@ -464,7 +622,11 @@ status removepcfromjerry(multiValueHashTable multihashpc, Jerry *jerry, char *ke
     if (!jerry || !key || !multihashpc) {
         return failure;
     }
-    status s = removeFromMultiValueHashTable(multihashpc, key, jerry);
+    PhysicalCharacteristics *pc = get_pc_of_jerry(jerry, key);
+    if (!pc) {
+        return failure;
+    }
+    status s = removeFromMultiValueHashTableByHandle(multihashpc, key, pc->entry);
     if (s == failure) {
         return failure;
     }
@@ -476,38 +638,54 @@ status removepcfromjerry(multiValueHashTable multihashpc, Jerry *jerry, char *ke
 }
 
 // Remove a Jerry from all data structures
-status removejerry(multiValueHashTable multihashpc, hashTable hashjerry, Jerry *jerry, linkedlist alljerries) {
+status removejerry(multiValueHashTable multihashpc, hashTable hashjerry, Jerry *jerry, linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins) {
     if (!jerry || !hashjerry || !multihashpc) {
         return failure;
     }
     for (int i = 0; i < jerry->pc_num; i++) {
-        if (jerry->PhysicalCharacteristics[i]) {
-            removeFromMultiValueHashTable(multihashpc, jerry->PhysicalCharacteristics[i]->name, jerry);
-        }
+        PhysicalCharacteristics *pc = &jerry->PhysicalCharacteristics[i];
+        removeFromMultiValueHashTableByHandle(multihashpc, get_pc_name(pc), pc->entry);
     }
-    deleteNode(alljerries, jerry);
+    sync_happiness(happy, jerry); // The origin index takes the Jerry's current level out of its aggregates
+    remove_from_origin_index(origins, jerry);
+    remove_from_happiness_index(happy, jerry);
+    remove_from_jerry_store(store, jerry); // Moves the last slot into the Jerry's one
+    removeNodeByHandle(alljerries, jerry->node);
     removeFromHashTable(hashjerry, getjerryid(jerry));
     return success;
 }
 
 // Add a new Jerry to the hash table and linked list
-Jerry *addjerrytotabele(hashTable jerryhash, char *id , char *reality , int happiness, Planet *planet, linkedlist alljerries) {
+Jerry *addjerrytotabele(hashTable jerryhash, char *id , char *reality , int happiness, Planet *planet, linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins) {
     if (!jerryhash || !id || !reality) {
         return NULL;
     }
-    Jerry *newjerry = create_jerry(id, reality, planet, happiness);
-    print_jerry(newjerry);
+    JerryDetails details = {id, reality, planet, happiness};
+    Jerry *newjerry = insert_new_jerry(jerryhash, &details);
     if (!newjerry) {
         return NULL;
     }
-
-    status s = addToHashTable(jerryhash, id, newjerry);
-    if (s == failure) {
-        free_jerry(newjerry);
+    print_jerry(newjerry);
+    newjerry->node = appendNodeWithHandle(alljerries, newjerry);
+    if (newjerry->node == NULL) {
+        removeFromHashTable(jerryhash, id);
         return NULL;
     }
-    s = appendNode(alljerries, newjerry);
-    if (s == failure) {
+    if (add_to_jerry_store(store, newjerry) == failure) {
+        removeNodeByHandle(alljerries, newjerry->node);
+        removeFromHashTable(jerryhash, id);
+        return NULL;
+    }
+    if (add_to_happiness_index(happy, newjerry) == failure) {
+        remove_from_jerry_store(store, newjerry);
+        removeNodeByHandle(alljerries, newjerry->node);
+        removeFromHashTable(jerryhash, id);
+        return NULL;
+    }
+    if (add_to_origin_index(origins, newjerry) == failure) {
+        remove_from_happiness_index(happy, newjerry);
+        remove_from_jerry_store(store, newjerry);
+        removeNodeByHandle(alljerries, newjerry->node);
         removeFromHashTable(jerryhash, id);
         return NULL;
     }
@@ -520,48 +698,23 @@ Jerry *similarjerry(hashTable jerryhash, multiValueHashTable multihashpc, char *
         return NULL;
     }
 
-    linkedlist all = lookupInMultiValueHashTable(multihashpc, pc);
-    if (!all || getLengthList(all) == 0) {
-        return NULL;
-    }
-
-    Jerry *most_similar = NULL;
-    float closest_diff = 999;
-
-    for (int i = 0; i < getLengthList(all); i++) {
-        Jerry *current = (Jerry *)getDataByIndex(all, i);
-        if (!current) {
-            continue;
-        }
-        for (int j = 0; j < current->pc_num; j++) {
-            if (strcmp(current->PhysicalCharacteristics[j]->name, pc) == 0) {
-                float diff = fabs(current->PhysicalCharacteristics[j]->val - val);
-                if (diff < closest_diff) {
-                    closest_diff = diff;
-                    most_similar = current;
-                }
-                break;
-            }
-        }
+    // Predecessor/successor search in the characteristic's value order
+    Jerry *most_similar = (Jerry *)nearestInMultiValueHashTable(multihashpc, pc, val);
+    PhysicalCharacteristics *closest = most_similar ? get_pc_of_jerry(most_similar, pc) : NULL;
+    if (!closest || !(fabs(closest->val - val) < 999)) {
+        return NULL; // Nothing closer than the historical 999 cut-off
     }
-
     return most_similar;
 }
 
 // Find the saddest Jerry in the linked list
-Jerry *saddestjerry(linkedlist alljerries) {
-    if (!alljerries) {
+Jerry *saddestjerry(happiness_index happy) {
+    if (!happy) {
         return NULL;
     }
-    int saddest = 999;
-    Jerry *newjerry = NULL;
-    for (int i = 0; i < getLengthList(alljerries); i++) {
-        Jerry *current = getDataByIndex(alljerries, i);
-        int temp = current->happiness;
-        if (temp < saddest) {
-            saddest = temp;
-            newjerry = current;
-        }
+    Jerry *newjerry = saddest_in_happiness_index(happy); // First inserted on ties
+    if (!newjerry || happiness_of(happy, newjerry) >= 999) {
+        return NULL; // Nothing sadder than the historical 999 cut-off
     }
     return newjerry;
 }
@@ -571,53 +724,30 @@ Planet *checkplanetname(PlanetList *planetlist, char *name) {
     if (!planetlist || !name) {
         return NULL;
     }
-    for (int i = 0; i < planetlist->size; i++) {
-        if (strcmp(planetlist->planets[i]->name, name) == 0) {
-            return planetlist->planets[i];
-        }
-    }
-    return NULL;
+    return find_planet(planetlist, name);
 }
 
 // Clean up all data structures
-status cleanall(linkedlist alljerries, multiValueHashTable multihashpc, hashTable hashjerry, PlanetList *planetList) {
+status cleanall(linkedlist alljerries, multiValueHashTable multihashpc, hashTable hashjerry, PlanetList *planetList, happiness_index happy, jerry_store store, origin_index origins, arena daycare) {
+    destroy_origin_index(origins);
+    destroy_happiness_index(happy);
+    destroy_jerry_store(store);
     destroyHashTable(hashjerry);
     destroyMultiValueHashTable(multihashpc);
     free_planet_list(planetList);
     destroyList(alljerries);
+    destroyInterner(); // After every record holding interned strings, before the arena they live in
+    destroyArena(daycare); // Every block left in the arena goes with its chunks
     return success;
 }
 
-// Ensure the happiness of a Jerry is within valid bounds (0-100)
-void valid_happiness(Jerry *jerry) {
-    if (!jerry) {
-        return;
-    }
-    if (jerry->happiness < 0) {
-        jerry->happiness = 0;
-        return;
-    }
-    if (jerry->happiness > 100) {
-        jerry->happiness = 100;
-        return;
-    }
-}
-
 // Update the happiness of all Jerries in the list based on conditions
-status update_happiness(linkedlist alljerries, int above, int addabove, int decbelow) {
-    if (!alljerries) {
+status update_happiness(linkedlist alljerries, happiness_index happy, origin_index origins, int above, int addabove, int decbelow) {
+    if (!alljerries || !happy || !origins) {
         return failure;
     }
-    for (int i = 0; i < getLengthList(alljerries); i++) {
-        Jerry *currentJ = (Jerry *)(getDataByIndex(alljerries, i));
-        if (currentJ->happiness >= above) {
-            currentJ->happiness += addabove;
-        } else {
-            currentJ->happiness -= decbelow;
-        }
-        valid_happiness(currentJ);
-    }
-    return success;
+    apply_activity_to_origin_index(origins, above, addabove, decbelow); // 101 steps per planet and reality
+    return apply_happiness_activity(happy, alljerries, above, addabove, decbelow); // Lazy: the happiness fields catch up when read
 }
 
 void print_menu(){
@@ -634,7 +764,7 @@ void print_menu(){
 }
 // Handle the addition of a new Jerry to the daycare
 //PLEASE NOTE - in all cases no need to chaka nulls pointer- it already not null if the menu works.
-status case1(hashTable hashjerry, PlanetList *planetList, linkedlist alljerries ) {
+status case1(hashTable hashjerry, PlanetList *planetList, linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins ) {
     char planet_ID[301] = {0};
     char jerry_dimension[301] = {0};
     char jerry_ID[301] ={0};
@@ -642,7 +772,7 @@ status case1(hashTable hashjerry, PlanetList *planetList, linkedlist alljerries
 
     printf("What is your Jerry's ID ? \n");
     scanf("%s", jerry_ID);
-    if (lookupInHashTable(hashjerry, jerry_ID) != NULL) {
+    if (borrowFromHashTable(hashjerry, jerry_ID) != NULL) {
         printf("Rick did you forgot ? you already left him here ! \n");
         return success;
     }
@@ -657,7 +787,7 @@ status case1(hashTable hashjerry, PlanetList *planetList, linkedlist alljerries
     scanf("%s", jerry_dimension);
     printf("How happy is your Jerry now ? \n");
     scanf("%d", &happiness);
-    Jerry *new = addjerrytotabele(hashjerry, jerry_ID, jerry_dimension, happiness,planet, alljerries );
+    Jerry *new = addjerrytotabele(hashjerry, jerry_ID, jerry_dimension, happiness,planet, alljerries, happy, store, origins );
     if (new == NULL) {
         return  failure;
     }
@@ -665,13 +795,13 @@ status case1(hashTable hashjerry, PlanetList *planetList, linkedlist alljerries
 }
 
 // Handle the addition of a physical characteristic to an existing Jerry
-status case2(hashTable JerrysHashTable, multiValueHashTable PC_MultiHashTable) {
+status case2(hashTable JerrysHashTable, multiValueHashTable PC_MultiHashTable, happiness_index happy) {
     char jerry_pc[301] = {0};
     char jerry_ID[301] ={0};
     float val= 0;
     printf("What is your Jerry's ID ? \n");
     scanf("%s", jerry_ID);
-    Jerry *jerry = lookupInHashTable(JerrysHashTable, jerry_ID);
+    Jerry *jerry = borrowFromHashTable(JerrysHashTable, jerry_ID);
     if (jerry == NULL) {
         printf("Rick this Jerry is not in the daycare ! \n");
         return success;
@@ -689,6 +819,7 @@ status case2(hashTable JerrysHashTable, multiValueHashTable PC_MultiHashTable) {
     if (continue_plan == failure) {
         return failure;
     }
+    sync_all_happiness(happy);
     continue_plan = displayMultiValueHashElementsByKey(PC_MultiHashTable, jerry_pc);
     if (continue_plan == failure) {
         return failure;
@@ -697,12 +828,12 @@ status case2(hashTable JerrysHashTable, multiValueHashTable PC_MultiHashTable) {
 }
 
 // Handle the removal of a physical characteristic from an existing Jerry
-status case3(hashTable hashjerry, multiValueHashTable multihashpc ) {
+status case3(hashTable hashjerry, multiValueHashTable multihashpc, happiness_index happy) {
     char jerry_pc[301] = {0};
     char jerry_ID[301] ={0};
     printf("What is your Jerry's ID ? \n");
     scanf("%s", jerry_ID);
-    Jerry *jerry1 = lookupInHashTable(hashjerry, jerry_ID);
+    Jerry *jerry1 = borrowFromHashTable(hashjerry, jerry_ID);
     if (jerry1 == NULL) {
         printf("Rick this Jerry is not in the daycare ! \n");
         return success;
@@ -717,21 +848,22 @@ status case3(hashTable hashjerry, multiValueHashTable multihashpc ) {
     if (continue_plan == failure) {
         return failure;
     }
+    sync_happiness(happy, jerry1);
     print_jerry(jerry1);
     return success;
 }
 
 // Handle the removal of a Jerry from the daycare
-status case4(hashTable hashjerry, multiValueHashTable multihashpc , linkedlist alljerries ) {
+status case4(hashTable hashjerry, multiValueHashTable multihashpc , linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins ) {
     char jerry_ID[301] ={0};
     printf("What is your Jerry's ID ? \n");
     scanf("%s", jerry_ID);
-    Jerry *jerry2 = lookupInHashTable(hashjerry, jerry_ID);
+    Jerry *jerry2 = borrowFromHashTable(hashjerry, jerry_ID);
     if (jerry2 == NULL) {
         printf("Rick this Jerry is not in the daycare ! \n");
         return success;
     }
-    status s = removejerry(multihashpc, hashjerry, jerry2, alljerries);
+    status s = removejerry(multihashpc, hashjerry, jerry2, alljerries, happy, store, origins);
     if (s == failure) {
         return failure;
     }
@@ -740,7 +872,7 @@ status case4(hashTable hashjerry, multiValueHashTable multihashpc , linkedlist a
 }
 
 // Handle finding a similar Jerry based on physical characteristics
-status case5(hashTable hashjerry, multiValueHashTable multihashpc , linkedlist alljerries ) {
+status case5(hashTable hashjerry, multiValueHashTable multihashpc , linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins ) {
     char jerry_pc[301] = {0};
     float val= 0;
     printf("What do you remember about your Jerry ? \n");
@@ -753,8 +885,9 @@ status case5(hashTable hashjerry, multiValueHashTable multihashpc , linkedlist a
     scanf("%f", &val);
     Jerry *to_remove = similarjerry(hashjerry, multihashpc, jerry_pc, val);
     printf("Rick this is the most suitable Jerry we found : \n");
+    sync_happiness(happy, to_remove);
     print_jerry(to_remove);
-    status s = removejerry(multihashpc, hashjerry, to_remove,alljerries);
+    status s = removejerry(multihashpc, hashjerry, to_remove,alljerries, happy, store, origins);
     if (s == failure) {
         return failure;
     }
@@ -763,11 +896,13 @@ status case5(hashTable hashjerry, multiValueHashTable multihashpc , linkedlist a
 }
 
 // Handle finding and removing the saddest Jerry
-status case6(hashTable hashjerry, multiValueHashTable multihashpc, linkedlist alljerries ) {
+status case6(hashTable hashjerry, multiValueHashTable multihashpc, linkedlist alljerries, happiness_index happy, jerry_store store, origin_index origins ) {
     if (getLengthList(alljerries) > 0) {
         printf("Rick this is the most suitable Jerry we found : \n");
-        print_jerry(saddestjerry(alljerries));
-        removejerry(multihashpc, hashjerry,saddestjerry(alljerries),alljerries );
+        Jerry *saddest = saddestjerry(happy); // Found once, printed and removed
+        sync_happiness(happy, saddest);
+        print_jerry(saddest);
+        removejerry(multihashpc, hashjerry,saddest,alljerries, happy, store, origins );
         printf("Rick thank you for using our daycare service ! Your Jerry awaits ! \n");
     } else {
         printf("Rick we can not help you - we currently have no Jerries in the daycare ! \n");
@@ -775,25 +910,116 @@ status case6(hashTable hashjerry, multiValueHashTable multihashpc, linkedlist al
     return success;
 }
 
+// Print a Jerry found by a range query and count it
+static bool print_jerry_in_range(Element jerry, Element found) {
+    print_jerry((Jerry *)jerry);
+    (*(int *)found)++;
+    return true;
+}
+
+// Print the Jerries whose characteristic value lies in a range, in value order
+status jerriesinrange(multiValueHashTable multihashpc, char *pc, float low, float high, int *found) {
+    if (!multihashpc || !pc || !found) {
+        return failure;
+    }
+    *found = 0;
+    return forEachInMultiValueRange(multihashpc, pc, low, high, print_jerry_in_range, found);
+}
+
+// State of a query printing Jerries
+typedef struct {
+    happiness_index happy;
+    int found; // Number of Jerries printed
+} JerryPrinter;
+
+// Bring a Jerry's happiness up to date, print it and count it
+static bool print_counted_jerry(Element jerry, Element context) {
+    JerryPrinter *printer = context;
+    sync_happiness(printer->happy, jerry);
+    print_jerry((Jerry *)jerry);
+    printer->found++;
+    return true;
+}
+
+// Print the Jerries of a list, syncing only them
+static int print_jerries(linkedlist jerries, happiness_index happy) {
+    JerryPrinter printer = {happy, 0};
+    if (jerries) {
+        forEachInList(jerries, print_counted_jerry, &printer);
+    }
+    return printer.found;
+}
+
+// Print the Jerries whose origin planet lies within a distance of a point: closest planet first, then in daycare order
+status jerriesnear(PlanetList *planetList, origin_index origins, happiness_index happy, coord point, float radius, int *found) {
+    if (!planetList || !origins || !found) {
+        return failure;
+    }
+    *found = 0;
+    Planet **planets = malloc((planetList->size > 0 ? planetList->size : 1) * sizeof(Planet *));
+    if (!planets) {
+        return failure;
+    }
+    int count = planets_within(planetList->near, point, radius, planets);
+    for (int i = 0; i < count; i++) {
+        *found += print_jerries(jerries_from_planet(origins, planets[i]), happy);
+    }
+    free(planets);
+    return count < 0 ? failure : success;
+}
+
+// Print an aggregate read from an index
+static void print_stats(char *name, runningAggregate *stats) {
+    printf("%s : count %ld , min %.2f , max %.2f , mean %.2f , variance %.2f \n", name, stats->count, stats->min,
+           stats->max, aggregateMean(stats), aggregateVariance(stats));
+}
+
+// Read the coordinates of a point
+static status read_point(coord *point) {
+    printf("What are the coordinates of the point ? \n");
+    float x = 0, y = 0, z = 0;
+    if (scanf("%f %f %f", &x, &y, &z) != 3) {
+        return failure;
+    }
+    *point = create_coord(x, y, z);
+    return success;
+}
+
 // Handle displaying information about Jerries or planets
-status case7(hashTable hashjerry, multiValueHashTable multihashpc, linkedlist alljerries, PlanetList *planetList) {
+status case7(hashTable hashjerry, multiValueHashTable multihashpc, linkedlist alljerries, PlanetList *planetList, happiness_index happy, origin_index origins) {
     printf("What information do you want to know ? \n"
            "1 : All Jerries \n"
            "2 : All Jerries by physical characteristics \n"
-           "3 : All known planets \n");
+           "3 : All known planets \n"
+           "4 : All Jerries by physical characteristics range \n"
+           "5 : Nearest planets to a point \n"
+           "6 : All planets within a distance of a point \n"
+           "7 : All Jerries from planets within a distance of a point \n"
+           "8 : All Jerries from a planet \n"
+           "9 : All Jerries from a dimension \n"
+           "10 : Statistics of a physical characteristic \n"
+           "11 : Happiness statistics of a planet \n"
+           "12 : Happiness statistics of a dimension \n");
     char jerry_pc[301] = {0};
     char choice7[301] = {0};
     int choice = 0;
+    float low = 0, high = 0;
+    int found = 0;
+    coord point = create_coord(0, 0, 0);
+    int count = 0;
+    runningAggregate stats;
+    Planet **near = NULL;
     scanf("%s",choice7);
-    if (is_valid2(choice7)) {
+    if (is_valid3(choice7)) {
         choice = atoi(choice7);
     }
     else {
-        choice = 4;
+        choice = 0;
     }
         switch (choice) {
             case 1: // All Jerries
                 if (getLengthList(alljerries) > 0) {
+                    sync_all_happiness(happy);
                     printList(alljerries);
                 } else {
                     printf("Rick we can not help you - we currently have no Jerries in the daycare ! \n");
@@ -809,6 +1035,7 @@ status case7(hashTable hashjerry, multiValueHashTable multihashpc, linkedlist al
                         return success;
                     }
                     if (lookupInMultiValueHashTable(multihashpc, jerry_pc) != NULL) {
+                        sync_all_happiness(happy);
                         displayMultiValueHashElementsByKey(multihashpc, jerry_pc);
                     } else {
                         printf("Rick we can not help you - we do not know any Jerry's %s ! \n", jerry_pc);
@@ -826,6 +1053,145 @@ status case7(hashTable hashjerry, multiValueHashTable multihashpc, linkedlist al
                     }
                     break;
 
+            case 4: // Jerries by physical characteristics range
+                printf("What physical characteristics ? \n");
+                if (scanf("%300s", jerry_pc) != 1) { // Limit input length to avoid buffer overflow
+                    printf("Rick invalid input for physical characteristics ! \n");
+                    return success;
+                }
+                if (lookupInMultiValueHashTable(multihashpc, jerry_pc) == NULL) {
+                    printf("Rick we can not help you - we do not know any Jerry's %s ! \n", jerry_pc);
+                    break;
+                }
+                printf("What is the lowest value of his %s ? \n", jerry_pc);
+                scanf("%f", &low);
+                printf("What is the highest value of his %s ? \n", jerry_pc);
+                scanf("%f", &high);
+                sync_all_happiness(happy);
+                jerriesinrange(multihashpc, jerry_pc, low, high, &found);
+                if (found == 0) {
+                    printf("Rick we can not help you - we do not know any Jerry's %s in this range ! \n", jerry_pc);
+                }
+                break;
+
+            case 5: // Nearest planets to a point
+                if (planet_tree_size(planetList->near) == 0) {
+                    printf("Rick we can not help you - no planets are available ! \n");
+                    break;
+                }
+                if (read_point(&point) == failure) {
+                    printf("Rick invalid input for the point ! \n");
+                    return success;
+                }
+                printf("How many planets ? \n");
+                if (scanf("%d", &count) != 1 || count <= 0) {
+                    printf("Rick invalid input for the number of planets ! \n");
+                    return success;
+                }
+                if (count > planet_tree_size(planetList->near)) {
+                    count = planet_tree_size(planetList->near);
+                }
+                near = malloc(count * sizeof(Planet *));
+                if (!near) {
+                    return failure;
+                }
+                count = nearest_planets(planetList->near, point, count, near);
+                for (int i = 0; i < count; i++) {
+                    print_planet(near[i]);
+                }
+                free(near);
+                if (count < 0) {
+                    return failure;
+                }
+                break;
+
+            case 6: // Planets within a distance of a point
+            case 7: // Jerries from planets within a distance of a point
+                if (read_point(&point) == failure) {
+                    printf("Rick invalid input for the point ! \n");
+                    return success;
+                }
+                printf("What is the distance ? \n");
+                if (scanf("%f", &low) != 1 || low < 0) {
+                    printf("Rick invalid input for the distance ! \n");
+                    return success;
+                }
+                if (choice == 7) {
+                    if (jerriesnear(planetList, origins, happy, point, low, &found) == failure) {
+                        return failure;
+                    }
+                    if (found == 0) {
+                        printf("Rick we can not help you - we do not know any Jerry from this area ! \n");
+                    }
+                    break;
+                }
+                near = malloc((planetList->size > 0 ? planetList->size : 1) * sizeof(Planet *));
+                if (!near) {
+                    return failure;
+                }
+                count = planets_within(planetList->near, point, low, near);
+                for (int i = 0; i < count; i++) {
+                    print_planet(near[i]);
+                }
+                free(near);
+                if (count < 0) {
+                    return failure;
+                }
+                if (count == 0) {
+                    printf("Rick we can not help you - no planets are in this area ! \n");
+                }
+                break;
+
+            case 8: // Jerries from a planet
+                printf("What planet ? \n");
+                if (scanf("%300s", jerry_pc) != 1) {
+                    printf("Rick invalid input for the planet ! \n");
+                    return success;
+                }
+                if (print_jerries(jerries_from_planet(origins, find_planet(planetList, jerry_pc)), happy) == 0) {
+                    printf("Rick we can not help you - we do not know any Jerry from %s ! \n", jerry_pc);
+                }
+                break;
+
+            case 9: // Jerries from a dimension
+                printf("What dimension ? \n");
+                if (scanf("%300s", jerry_pc) != 1) {
+                    printf("Rick invalid input for the dimension ! \n");
+                    return success;
+                }
+                if (print_jerries(jerries_from_reality(origins, jerry_pc), happy) == 0) {
+                    printf("Rick we can not help you - we do not know any Jerry from %s ! \n", jerry_pc);
+                }
+                break;
+
+            case 10: // Statistics of a physical characteristic
+                printf("What physical characteristics ? \n");
+                if (scanf("%300s", jerry_pc) != 1) {
+                    printf("Rick invalid input for physical characteristics ! \n");
+                    return success;
+                }
+                if (getMultiValueStats(multihashpc, jerry_pc, &stats) == failure) {
+                    printf("Rick we can not help you - we do not know any Jerry's %s ! \n", jerry_pc);
+                    break;
+                }
+                print_stats(jerry_pc, &stats);
+                break;
+
+            case 11: // Happiness statistics of a planet
+            case 12: // Happiness statistics of a dimension
+                printf(choice == 11 ? "What planet ? \n" : "What dimension ? \n");
+                if (scanf("%300s", jerry_pc) != 1) {
+                    printf("Rick invalid input ! \n");
+                    return success;
+                }
+                if ((choice == 11 ? planet_happiness_stats(origins, find_planet(planetList, jerry_pc), &stats)
+                                  : reality_happiness_stats(origins, jerry_pc, &stats)) == failure) {
+                    printf("Rick we can not help you - we do not know any Jerry from %s ! \n", jerry_pc);
+                    break;
+                }
+                print_stats(jerry_pc, &stats);
+                break;
+
             default:
                 printf("Rick this option is not known to the daycare ! \n");
             break;
@@ -835,7 +1201,7 @@ status case7(hashTable hashjerry, multiValueHashTable multihashpc, linkedlist al
 }
 
 // Handle initiating activities for Jerries
-status case8(linkedlist alljerries) {
+status case8(linkedlist alljerries, happiness_index happy, origin_index origins) {
     if (getLengthList(alljerries) > 0) {
         printf("What activity do you want the Jerries to partake in ? \n"
             "1 : Interact with fake Beth \n"
@@ -852,18 +1218,21 @@ status case8(linkedlist alljerries) {
         }
             switch (choice3) {
                 case 1:
-                    update_happiness(alljerries,20,15,5);
+                    update_happiness(alljerries,happy,origins,20,15,5);
                     printf("The activity is now over ! \n");
+                    sync_all_happiness(happy);
                     printList(alljerries);
                 break;
                 case 2:
-                    update_happiness(alljerries,50,10,10);
+                    update_happiness(alljerries,happy,origins,50,10,10);
                     printf("The activity is now over ! \n");
+                    sync_all_happiness(happy);
                     printList(alljerries);
                 break;
                 case 3:
-                    update_happiness(alljerries,0,20,0);
+                    update_happiness(alljerries,happy,origins,0,20,0);
                     printf("The activity is now over ! \n");
+                    sync_all_happiness(happy);
                     printList(alljerries);
                 break;
                 case 4:
@@ -877,8 +1246,8 @@ status case8(linkedlist alljerries) {
 }
 
 // Handle closing the daycare and cleaning up all data
-status case9(linkedlist alljerries, multiValueHashTable multihashpc, hashTable hashjerry, PlanetList *planetList) {
-    cleanall(alljerries, multihashpc, hashjerry, planetList);
+status case9(linkedlist alljerries, multiValueHashTable multihashpc, hashTable hashjerry, PlanetList *planetList, happiness_index happy, jerry_store store, origin_index origins, arena daycare) {
+    cleanall(alljerries, multihashpc, hashjerry, planetList, happy, store, origins, daycare);
     printf("The daycare is now clean and close ! \n");
     return success;
 }
@@ -888,29 +1257,37 @@ int main(int argc, char *argv[]) {
     int num_of_planets = atoi(argv[1]); // Get number of planets
     char *datafile = argv[2]; // Get data file name
 
-    // Initialize counters for Jerries and planetary characteristics
-    int  numofjerrys = 0;
-    int  numofpc = 0;
-    count_elements_infile(datafile, &numofjerrys, &numofpc); // Count elements in the data file
-
-    // Find the nearest prime numbers for hash table sizes
-    numofjerrys  = find_close_prime(numofjerrys);
-    numofpc = find_close_prime(numofpc);
+    // Size the tables from the file size rather than a counting pass over the file; they grow as needed
+    int numofjerrys = find_close_prime(estimate_jerries_infile(datafile));
+    int numofpc = find_close_prime(EXPECTED_PC_NAMES);
 
     // Initialize data structures
     PlanetList *planetList = NULL;
 
+    // Create the arena holding the records that live as long as the daycare
+    arena daycare = createArena(0);
+    if (!daycare) {
+        printf(" A memory problem has been detected in the program");
+        exit(1);
+    }
+    Allocator daycare_allocator = arenaAllocator(daycare);
+    set_jerry_allocator(&daycare_allocator); // Planets, origins, Jerries and characteristics
+    setInternerAllocator(&daycare_allocator); // Names and realities
+
     // Create a linked list for Jerries
     linkedlist alljerries = createLinkedList(copyJerryVal, NOTfreejerrys, equaljerrys, print_jerry_val);
     if (!alljerries) {
+        destroyArena(daycare);
         printf(" A memory problem has been detected in the program");
         exit(1);
     }
+    setListAllocator(alljerries, &daycare_allocator);
 
     // Create a hash table for Jerries
     hashTable hashjerry = createHashJerry(numofjerrys);
     if (!hashjerry) {
         destroyList(alljerries);
+        destroyArena(daycare);
         printf(" A memory problem has been detected in the program");
         exit(1);
     }
@@ -920,18 +1297,69 @@ int main(int argc, char *argv[]) {
     if (!multihashpc) {
         destroyList(alljerries);
         destroyHashTable(hashjerry);
+        destroyArena(daycare);
+        exit(1);
+    }
+    setMultiValueAllocator(multihashpc, &daycare_allocator);
+
+    // Create the store of the fields scanned over every Jerry
+    jerry_store store = create_jerry_store();
+    if (!store) {
+        destroyList(alljerries);
+        destroyHashTable(hashjerry);
+        destroyMultiValueHashTable(multihashpc);
+        destroyArena(daycare);
+        exit(1);
+    }
+
+    // Create the happiness index used to find the saddest Jerry
+    happiness_index happy = create_happiness_index(store);
+    if (!happy) {
+        destroy_jerry_store(store);
+        destroyList(alljerries);
+        destroyHashTable(hashjerry);
+        destroyMultiValueHashTable(multihashpc);
+        destroyArena(daycare);
+        exit(1);
+    }
+    set_happiness_index_allocator(happy, &daycare_allocator);
+
+    // Create the indexes of Jerries by planet and by reality
+    origin_index origins = create_origin_index(find_close_prime(num_of_planets), &daycare_allocator);
+    if (!origins) {
+        destroy_happiness_index(happy);
+        destroy_jerry_store(store);
+        destroyList(alljerries);
+        destroyHashTable(hashjerry);
+        destroyMultiValueHashTable(multihashpc);
+        destroyArena(daycare);
         exit(1);
     }
 
     // Load data from the file into the data structures
-    status op_status = load_file(datafile, &planetList, hashjerry, num_of_planets, multihashpc, alljerries);
+    LoadTimings timings = {0};
+    timings.enabled = getenv("JERRYBOREE_TIMINGS") != NULL; // Read once: the loader never touches the clock otherwise
+    status op_status = load_file(datafile, &planetList, hashjerry, num_of_planets, multihashpc, alljerries, happy, store, origins, &timings);
     if (op_status == failure) {
         // Cleanup on failure
-        cleanall(alljerries, multihashpc, hashjerry, planetList);
+        cleanall(alljerries, multihashpc, hashjerry, planetList, happy, store, origins, daycare);
         printf(" A memory problem has been detected in the program");
         exit(1);
     }
 
+    // Index the planets by coordinates, now that they are all known
+    start_phases(&timings);
+    planetList->near = create_planet_tree(planetList->planets, planetList->size);
+    if (!planetList->near) {
+        cleanall(alljerries, multihashpc, hashjerry, planetList, happy, store, origins, daycare);
+        printf(" A memory problem has been detected in the program");
+        exit(1);
+    }
+    end_phase(&timings, &timings.index);
+    if (timings.enabled) { // On stderr, so the program's output is unchanged
+        fprintf(stderr, "load: read %.3f s , parse %.3f s , index %.3f s\n", timings.read, timings.parse, timings.index);
+    }
+
     // Main program loop
     status continue_plan = success;
     while (continue_plan == success) {
@@ -946,31 +1374,31 @@ int main(int argc, char *argv[]) {
         // Handle menu options
         switch (choice) {
             case 1:
-                continue_plan = case1(hashjerry, planetList, alljerries);
+                continue_plan = case1(hashjerry, planetList, alljerries, happy, store, origins);
                 break;
             case 2:
-                continue_plan = case2(hashjerry, multihashpc);
+                continue_plan = case2(hashjerry, multihashpc, happy);
                 break;
             case 3:
-                continue_plan = case3(hashjerry, multihashpc);
+                continue_plan = case3(hashjerry, multihashpc, happy);
                 break;
             case 4:
-                continue_plan = case4(hashjerry, multihashpc, alljerries);
+                continue_plan = case4(hashjerry, multihashpc, alljerries, happy, store, origins);
                 break;
             case 5:
-                continue_plan = case5(hashjerry, multihashpc, alljerries);
+                continue_plan = case5(hashjerry, multihashpc, alljerries, happy, store, origins);
                 break;
             case 6:
-                continue_plan = case6(hashjerry, multihashpc, alljerries);
+                continue_plan = case6(hashjerry, multihashpc, alljerries, happy, store, origins);
                 break;
             case 7:
-                continue_plan = case7(hashjerry, multihashpc, alljerries, planetList);
+                continue_plan = case7(hashjerry, multihashpc, alljerries, planetList, happy, origins);
                 break;
             case 8:
-                continue_plan = case8(alljerries);
+                continue_plan = case8(alljerries, happy, origins);
                 break;
             case 9:
-                case9(alljerries, multihashpc, hashjerry, planetList);
+                case9(alljerries, multihashpc, hashjerry, planetList, happy, store, origins, daycare);
                 exit(0);
             default:
                 printf("Rick this option is not known to the daycare ! \n");
@@ -979,7 +1407,7 @@ int main(int argc, char *argv[]) {
     }
 
     // Cleanup and exit on error
-    cleanall(alljerries, multihashpc, hashjerry, planetList);
+    cleanall(alljerries, multihashpc, hashjerry, planetList, happy, store, origins, daycare);
     printf(" A memory problem has been detected in the program \n");
     exit(1);
 }
@@ -0,0 +1,130 @@
+#include "JerryStore.h"
+
+// Capacity of the first columns, doubled whenever the store is full
+#define INITIAL_CAPACITY 16
+
+// Jerry store structure: the cold table and the hot columns, all indexed by slot
+typedef struct jerry_store_s {
+    Jerry **jerries; // Jerry record of each slot
+    int *happiness; // Happiness of each slot
+    int *mood_base; // Happiness bucket base level of each slot
+    unsigned long long *mood_seq; // Happiness index insertion number of each slot
+    int size; // Number of slots in use
+    int capacity; // Number of slots allocated in every column
+} JerryStore;
+
+// Grow one column to a new number of slots, leaving it as is on failure
+static status grow_column(void **column, size_t item_size, int capacity) {
+    void *grown = realloc(*column, capacity * item_size);
+    if (!grown) {
+        return failure;
+    }
+    *column = grown;
+    return success;
+}
+
+// Double the number of slots of every column
+static status grow_store(JerryStore *store) {
+    int capacity = store->capacity ? store->capacity * 2 : INITIAL_CAPACITY;
+    if (grow_column((void **)&store->jerries, sizeof(Jerry *), capacity) == failure ||
+        grow_column((void **)&store->happiness, sizeof(int), capacity) == failure ||
+        grow_column((void **)&store->mood_base, sizeof(int), capacity) == failure ||
+        grow_column((void **)&store->mood_seq, sizeof(unsigned long long), capacity) == failure) {
+        return failure; // Columns already grown are only larger than needed
+    }
+    store->capacity = capacity;
+    return success;
+}
+
+// Check that a Jerry holds a slot of this store
+static bool holds(JerryStore *store, Jerry *jerry) {
+    return jerry->slot >= 0 && jerry->slot < store->size && store->jerries[jerry->slot] == jerry;
+}
+
+// Create an empty Jerry store
+jerry_store create_jerry_store(void) {
+    JerryStore *store = calloc(1, sizeof(JerryStore)); // Every column starts NULL and empty
+    if (!store) {
+        return NULL;
+    }
+    if (grow_store(store) == failure) {
+        destroy_jerry_store(store);
+        return NULL;
+    }
+    return store;
+}
+
+// Free a Jerry store and its columns
+void destroy_jerry_store(jerry_store store) {
+    if (!store) {
+        return;
+    }
+    free(store->jerries);
+    free(store->happiness);
+    free(store->mood_base);
+    free(store->mood_seq);
+    free(store);
+}
+
+// Give a Jerry the next free slot
+status add_to_jerry_store(jerry_store store, Jerry *jerry) {
+    if (!store || !jerry) {
+        return failure;
+    }
+    if (store->size == store->capacity && grow_store(store) == failure) {
+        return failure;
+    }
+    int slot = store->size++;
+    store->jerries[slot] = jerry;
+    store->happiness[slot] = jerry->happiness;
+    store->mood_base[slot] = -1;
+    store->mood_seq[slot] = 0;
+    jerry->slot = slot;
+    return success;
+}
+
+// Remove a Jerry, moving the last slot into its place
+status remove_from_jerry_store(jerry_store store, Jerry *jerry) {
+    if (!store || !jerry || !holds(store, jerry)) {
+        return failure;
+    }
+    int slot = jerry->slot;
+    int last = --store->size;
+    if (slot != last) {
+        store->jerries[slot] = store->jerries[last];
+        store->happiness[slot] = store->happiness[last];
+        store->mood_base[slot] = store->mood_base[last];
+        store->mood_seq[slot] = store->mood_seq[last];
+        store->jerries[slot]->slot = slot;
+    }
+    jerry->slot = -1;
+    return success;
+}
+
+// Get the number of slots in use
+int jerry_store_size(jerry_store store) {
+    return store ? store->size : 0;
+}
+
+// Get the Jerry held in a slot
+Jerry *jerry_in_slot(jerry_store store, int slot) {
+    if (!store || slot < 0 || slot >= store->size) {
+        return NULL;
+    }
+    return store->jerries[slot];
+}
+
+// Get the happiness column
+int *happiness_column(jerry_store store) {
+    return store ? store->happiness : NULL;
+}
+
+// Get the happiness bucket base column
+int *mood_base_column(jerry_store store) {
+    return store ? store->mood_base : NULL;
+}
+
+// Get the happiness index insertion number column
+unsigned long long *mood_seq_column(jerry_store store) {
+    return store ? store->mood_seq : NULL;
+}
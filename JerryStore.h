@@ -0,0 +1,92 @@
+
+#ifndef JERRYSTORE_H
+#define JERRYSTORE_H
+#include "Defs.h"
+#include "Jerry.h"
+
+/**
+ * @file JerryStore.h
+ * @brief A structure-of-arrays store of the fields scanned over every Jerry.
+ *
+ * Each Jerry in the store holds a dense slot, kept in its `slot` field, and
+ * its hot fields live in parallel arrays indexed by that slot: happiness
+ * and the bookkeeping of the happiness index. The Jerry records themselves
+ * (ID, origin, characteristics) form the cold table, so a scan over the
+ * columns touches contiguous memory only. Characteristic values are not
+ * kept here: the characteristics table orders them, and the similar Jerry
+ * search is a lookup in that order rather than a scan. Removing a Jerry
+ * moves the last slot into the hole, so slots stay dense but their order is
+ * not the insertion order.
+ *
+ * Column pointers are invalidated by the next addition to the store.
+ * The store never copies or frees the Jerries it refers to.
+ */
+
+/** A type for a Jerry store handle. */
+typedef struct jerry_store_s *jerry_store;
+
+/**
+ * Creates a new, empty Jerry store.
+ * @return A handle to the new store, or NULL if memory allocation fails.
+ */
+jerry_store create_jerry_store(void);
+
+/**
+ * Frees a Jerry store and its columns. The Jerries themselves are not freed.
+ * @param store The store to free.
+ */
+void destroy_jerry_store(jerry_store store);
+
+/**
+ * Gives a Jerry the next free slot, with its current happiness.
+ * @param store The Jerry store.
+ * @param jerry The Jerry to add. Its `slot` field is set.
+ * @return `success` if the Jerry was added, otherwise `failure`.
+ */
+status add_to_jerry_store(jerry_store store, Jerry *jerry);
+
+/**
+ * Removes a Jerry in constant time per column, moving the last slot into its place.
+ * @param store The Jerry store.
+ * @param jerry The Jerry to remove. Its `slot` field is reset to -1.
+ * @return `success` if the Jerry was removed, otherwise `failure`.
+ */
+status remove_from_jerry_store(jerry_store store, Jerry *jerry);
+
+/**
+ * Gets the number of Jerries in the store, one past the last slot in use.
+ * @param store The Jerry store.
+ * @return The number of Jerries, or 0 if the store is NULL.
+ */
+int jerry_store_size(jerry_store store);
+
+/**
+ * Gets the Jerry held in a slot (the cold table).
+ * @param store The Jerry store.
+ * @param slot The slot.
+ * @return The Jerry, or NULL if the slot is not in use.
+ */
+Jerry *jerry_in_slot(jerry_store store, int slot);
+
+/**
+ * Gets the happiness column.
+ * @param store The Jerry store.
+ * @return The happiness of each slot, or NULL if the store is NULL.
+ */
+int *happiness_column(jerry_store store);
+
+/**
+ * Gets the column of happiness bucket base levels kept by the happiness index.
+ * @param store The Jerry store.
+ * @return The base level of each slot, or NULL if the store is NULL.
+ */
+int *mood_base_column(jerry_store store);
+
+/**
+ * Gets the column of insertion numbers kept by the happiness index.
+ * @param store The Jerry store.
+ * @return The insertion number of each slot, or NULL if the store is NULL.
+ */
+unsigned long long *mood_seq_column(jerry_store store);
+
+#endif //JERRYSTORE_H
@@ -4,86 +4,79 @@
 
 #include "KeyValuePair.h"
 
-// Definition of the Key_Value structure, which contains key-value pairs and their associated functions
+// Definition of the Key_Value structure. The functions handling the key and value
+// live in a PairTraits shared by the whole table, so a pair holds only its data.
 typedef struct Key_Value {
   Element key;                      // Key element
   Element value;                    // Value element
-
-  CopyFunction copyKey;             // Function to copy the key
-  CopyFunction copyValue;           // Function to copy the value
-  EqualFunction compareKey;         // Function to compare keys
-  FreeFunction destroyKey;          // Function to destroy the key
-  FreeFunction destroyValue;        // Function to destroy the value
-  PrintFunction printKey;           // Function to print the key
-  PrintFunction printValue;         // Function to print the value
+  unsigned long long hash;          // Cached hash of the key
+  struct Key_Value *next;           // Next pair in the same chain
 } Key_Value_Pair;
 
+// Function to check that all the functions of a PairTraits are provided
+bool validPairTraits(const PairTraits *traits) {
+  if (traits == NULL) {
+    return false;
+  }
+  return traits->copyKey != NULL && traits->copyValue != NULL && traits->compareKey != NULL &&
+         traits->destroyKey != NULL && traits->destroyValue != NULL && traits->printKey != NULL &&
+         traits->printValue != NULL;
+}
+
 // Function to create a KeyValuePair
-KeyValuePair createKeyValuePair(Element key, Element val, CopyFunction copyKey, CopyFunction copyValue, EqualFunction comperKey, FreeFunction destroyKey, FreeFunction destroyValue, PrintFunction printKey, PrintFunction printValue) {
-  // Ensure all function pointers are not NULL
-  if (copyKey == NULL || copyValue == NULL || comperKey == NULL || destroyKey == NULL || destroyValue == NULL || printValue == NULL || printKey == NULL) {
+KeyValuePair createKeyValuePair(Element key, Element val, const PairTraits *traits, unsigned long long hash) {
+  // Ensure the value and all function pointers are not NULL
+  if (val == NULL || !validPairTraits(traits)) {
     return NULL;
   }
 
   // Allocate memory for the Key_Value_Pair structure
-  Key_Value_Pair *key_val = (Key_Value_Pair *)malloc(sizeof(Key_Value_Pair));
+  Key_Value_Pair *key_val = (Key_Value_Pair *)allocateBlock(traits->allocator, sizeof(Key_Value_Pair));
   if (key_val == NULL) {
     return NULL; // Return NULL if memory allocation fails
   }
 
   // Copy the key and check if the copy was successful
-  key_val->key = copyKey(key);
+  key_val->key = traits->copyKey(key);
   if (key_val->key == NULL) {
-    free(key_val); // Free allocated memory if key copy fails
-    return NULL;
-  }
-
-  // Copy the value and check if the copy was successful
-  key_val->value = copyValue(val);
-  if (key_val->value == NULL) {
-    destroyKey(key_val->key); // Destroy the copied key if value copy fails
-    free(key_val); // Free allocated memory
+    releaseBlock(traits->allocator, key_val, sizeof(Key_Value_Pair)); // Free allocated memory if key copy fails
     return NULL;
   }
 
-  // Initialize function pointers
-  key_val->copyKey = copyKey;
-  key_val->copyValue = copyValue;
-  key_val->compareKey = comperKey;
-  key_val->destroyKey = destroyKey;
-  key_val->destroyValue = destroyValue;
-  key_val->printKey = printKey;
-  key_val->printValue = printValue;
+  // The value is taken as is: the caller already copied it if needed
+  key_val->value = val;
+  key_val->hash = hash;
+  key_val->next = NULL;
 
   return key_val; // Return the created KeyValuePair
 }
 
 // Function to destroy a KeyValuePair and free its resources
-status destroyKeyValuePair(KeyValuePair pair) {
-  if (pair == NULL) {
+status destroyKeyValuePair(KeyValuePair pair, const PairTraits *traits) {
+  if (pair == NULL || traits == NULL) {
     return failure; // Return failure if the pair is NULL
   }
 
   // Destroy the key and value if they exist
   if (pair->key != NULL) {
-    pair->destroyKey(pair->key);
+    traits->destroyKey(pair->key);
   }
   if (pair->value != NULL) {
-    pair->destroyValue(pair->value);
+    traits->destroyValue(pair->value);
   }
 
-  free(pair); // Free the memory of the KeyValuePair
+  releaseBlock(traits->allocator, pair, sizeof(Key_Value_Pair)); // Free the memory of the KeyValuePair
   return success; // Return success
 }
 
 // Function to display the value of a KeyValuePair
-status displayValue(KeyValuePair keyValuePair) {
-  if (keyValuePair == NULL) {
+status displayValue(KeyValuePair keyValuePair, const PairTraits *traits) {
+  if (keyValuePair == NULL || traits == NULL) {
     return failure; // Return failure if the KeyValuePair is NULL
   }
 
   if (keyValuePair->value != NULL) {
-    keyValuePair->printValue(keyValuePair->value); // Print the value
+    traits->printValue(keyValuePair->value); // Print the value
     return success;
   }
 
@@ -91,13 +84,13 @@ status displayValue(KeyValuePair keyValuePair) {
 }
 
 // Function to display the key of a KeyValuePair
-status displayKey(KeyValuePair keyValuePair) {
-  if (keyValuePair == NULL) {
+status displayKey(KeyValuePair keyValuePair, const PairTraits *traits) {
+  if (keyValuePair == NULL || traits == NULL) {
     return failure; // Return failure if the KeyValuePair is NULL
   }
 
   if (keyValuePair->key != NULL) {
-    keyValuePair->printKey(keyValuePair->key); // Print the key
+    traits->printKey(keyValuePair->key); // Print the key
     return success;
   }
 
@@ -105,27 +98,58 @@ status displayKey(KeyValuePair keyValuePair) {
 }
 
 // Function to get the key from a KeyValuePair
-KeyValuePair getKey(KeyValuePair keyValuePair) {
-  if (keyValuePair == NULL) {
+Element getKey(KeyValuePair keyValuePair, const PairTraits *traits) {
+  if (keyValuePair == NULL || traits == NULL) {
     return NULL; // Return NULL if the KeyValuePair is NULL
   }
 
-  return keyValuePair->copyKey(keyValuePair->key); // Return the key
+  return traits->copyKey(keyValuePair->key); // Return the key
 }
 
 // Function to get the value from a KeyValuePair
-KeyValuePair getValue(KeyValuePair keyValuePair) {
+Element getValue(KeyValuePair keyValuePair, const PairTraits *traits) {
+  if (keyValuePair == NULL || traits == NULL) {
+    return NULL; // Return NULL if the KeyValuePair is NULL
+  }
+
+  return traits->copyValue(keyValuePair->value); // Return the value
+}
+
+// Function to get the key from a KeyValuePair without copying it
+Element borrowKey(KeyValuePair keyValuePair) {
+  if (keyValuePair == NULL) {
+    return NULL; // Return NULL if the KeyValuePair is NULL
+  }
+
+  return keyValuePair->key;
+}
+
+// Function to get the value from a KeyValuePair without copying it
+Element borrowValue(KeyValuePair keyValuePair) {
   if (keyValuePair == NULL) {
     return NULL; // Return NULL if the KeyValuePair is NULL
   }
 
-  KeyValuePair pair = (KeyValuePair)keyValuePair;
-  return keyValuePair->copyValue(pair->value); // Return the value
+  return keyValuePair->value;
+}
+
+// Function to get the cached hash of the key
+unsigned long long getKeyHash(KeyValuePair keyValuePair) {
+  if (keyValuePair == NULL) {
+    return 0; // Return 0 if the KeyValuePair is NULL
+  }
+
+  return keyValuePair->hash;
+}
+
+// Function to get the size of a KeyValuePair block
+size_t getKeyValuePairSize(void) {
+  return sizeof(Key_Value_Pair);
 }
 
 // Function to check if the key in a KeyValuePair is equal to a given key
-bool isEqualkey(KeyValuePair pair, Element key) {
-  if (key == NULL || pair == NULL) {
+bool isEqualkey(KeyValuePair pair, Element key, const PairTraits *traits) {
+  if (key == NULL || pair == NULL || traits == NULL) {
     return false; // Return false if either the key or pair is NULL
   }
 
@@ -133,17 +157,17 @@ bool isEqualkey(KeyValuePair pair, Element key) {
     return false; // Return false if the key in the pair is NULL
   }
 
-  return pair->compareKey(pair->key, key); // Compare the keys and return the result
+  return traits->compareKey(pair->key, key); // Compare the keys and return the result
 }
 
 // Function to display both the key and value of a KeyValuePair
-status displaypair(KeyValuePair pair) {
+status displaypair(KeyValuePair pair, const PairTraits *traits) {
   if (!pair) {
     return failure; // Return failure if the KeyValuePair is NULL
   }
 
-  status a = displayKey(pair); // Display the key
-  status b = displayValue(pair); // Display the value
+  status a = displayKey(pair, traits); // Display the key
+  status b = displayValue(pair, traits); // Display the value
 
   // Return failure if either displayKey or displayValue fails
   if (b == failure || a == failure) {
@@ -152,3 +176,22 @@ status displaypair(KeyValuePair pair) {
 
   return success; // Return success if both displayKey and displayValue succeed
 }
+
+// Function to get the next pair in the chain
+KeyValuePair getNextPair(KeyValuePair keyValuePair) {
+  if (keyValuePair == NULL) {
+    return NULL; // Return NULL if the KeyValuePair is NULL
+  }
+
+  return keyValuePair->next;
+}
+
+// Function to set the next pair in the chain
+status setNextPair(KeyValuePair keyValuePair, KeyValuePair next) {
+  if (keyValuePair == NULL) {
+    return failure; // Return failure if the KeyValuePair is NULL
+  }
+
+  keyValuePair->next = next;
+  return success;
+}
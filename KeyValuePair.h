@@ -6,44 +6,58 @@
 #define KEYVALUEPAIR_H
 
 #include "Defs.h"
+#include "Allocator.h"
 
 // Define KeyValuePair as a pointer to the Key_Value structure
 typedef struct Key_Value* KeyValuePair;
 
-// The following typedefs (commented out) might be useful for understanding the required function signatures for elements:
-// typedef element (*copyKey)(element); // Function to copy a key element
-// typedef element (*copyValue)(element); // Function to copy a value element
-// typedef bool (*compareKey)(element, element); // Function to compare two key elements
-// typedef status (*destroyKey)(element); // Function to destroy a key element
-// typedef status (*destroyValue)(element); // Function to destroy a value element
-// typedef status (*printKey)(element); // Function to print a key element
-// typedef status (*printValue)(element); // Function to print a value element
+/**
+ * The functions that handle the keys and values of a collection of pairs.
+ * Every pair of a hash table shares the table's single, immutable PairTraits,
+ * so a pair only stores its key, value, cached hash and chain link.
+ */
+typedef struct {
+  CopyFunction copyKey;             // Function to copy a key element
+  CopyFunction copyValue;           // Function to copy a value element
+  EqualFunction compareKey;         // Function to compare two key elements
+  FreeFunction destroyKey;          // Function to destroy a key element
+  FreeFunction destroyValue;        // Function to destroy a value element
+  PrintFunction printKey;           // Function to print a key element
+  PrintFunction printValue;         // Function to print a value element
+  const Allocator *allocator;       // Source of the pairs, NULL for malloc
+} PairTraits;
+
+/**
+ * Checks that every function of a PairTraits is provided.
+ *
+ * @param traits - The PairTraits to check.
+ *
+ * @return `true` if traits and all of its functions are not NULL, `false` otherwise.
+ */
+bool validPairTraits(const PairTraits *traits);
 
 /**
  * Creates a new KeyValuePair object.
  *
- * @param key - The key element for the pair.
- * @param val - The value element for the pair.
- * @param copyKey - Function to copy the key element.
- * @param copyValue - Function to copy the value element.
- * @param comperKey - Function to compare two key elements.
- * @param destroyKey - Function to free memory of the key element.
- * @param destroyValue - Function to free memory of the value element.
- * @param printKey - Function to print the key element.
- * @param printValue - Function to print the value element.
+ * @param key - The key element for the pair. It is copied with traits->copyKey.
+ * @param val - The value element for the pair. It is stored as is, not copied: the pair takes ownership of it.
+ * @param traits - The functions handling the key and value. Not stored in the pair; pass the same traits to the other functions.
+ * @param hash - The full hash of the key, cached so the key never has to be hashed again.
  *
  * @return A pointer to the created KeyValuePair, or NULL if an error occurs.
  *
  * Notes:
- * - The provided functions must not be NULL; otherwise, the creation will fail.
- * - The caller is responsible for ensuring that the key and value are valid and compatible with the provided functions.
+ * - The traits must be valid (see validPairTraits); otherwise, the creation will fail.
+ * - The key is copied; the value is not copied, so a failed creation leaves it with the caller.
+ * - The new pair is not linked to any other pair.
  */
-KeyValuePair createKeyValuePair(Element key, Element val, CopyFunction copyKey, CopyFunction copyValue, EqualFunction comperKey, FreeFunction destroyKey, FreeFunction destroyValue, PrintFunction printKey, PrintFunction printValue);
+KeyValuePair createKeyValuePair(Element key, Element val, const PairTraits *traits, unsigned long long hash);
 
 /**
  * Frees the memory used by a KeyValuePair.
  *
  * @param keyValuePair - The KeyValuePair to destroy.
+ * @param traits - The traits the pair was created with.
  *
  * @return `success` if the operation was successful, `failure` otherwise.
  *
@@ -51,69 +65,109 @@ KeyValuePair createKeyValuePair(Element key, Element val, CopyFunction copyKey,
  * - Safely frees both the key and value elements using their respective destroy functions.
  * - If the KeyValuePair is NULL, no operation is performed.
  */
-status destroyKeyValuePair(KeyValuePair keyValuePair);
+status destroyKeyValuePair(KeyValuePair keyValuePair, const PairTraits *traits);
 
 /**
- * Displays the value of the KeyValuePair using the provided print function.
- *
- * @param keyValuePair - The KeyValuePair whose value will be displayed.
+ * Displays the value of the KeyValuePair using the print function of the traits.
  *
  * @return `success` if the value was displayed, `failure` if the value or KeyValuePair is NULL.
  */
-status displayValue(KeyValuePair keyValuePair);
+status displayValue(KeyValuePair keyValuePair, const PairTraits *traits);
 
 /**
- * Displays the key of the KeyValuePair using the provided print function.
- *
- * @param keyValuePair - The KeyValuePair whose key will be displayed.
+ * Displays the key of the KeyValuePair using the print function of the traits.
  *
  * @return `success` if the key was displayed, `failure` if the key or KeyValuePair is NULL.
  */
-status displayKey(KeyValuePair keyValuePair);
+status displayKey(KeyValuePair keyValuePair, const PairTraits *traits);
 
 /**
- * Retrieves the key from the KeyValuePair.
+ * Retrieves a copy of the key from the KeyValuePair, made with traits->copyKey.
  *
- * @param keyValuePair - The KeyValuePair to query.
+ * @return The key element, or NULL if the KeyValuePair is NULL.
+ */
+Element getKey(KeyValuePair keyValuePair, const PairTraits *traits);
+
+/**
+ * Retrieves a copy of the value from the KeyValuePair, made with traits->copyValue.
+ *
+ * @return The value element, or NULL if the KeyValuePair is NULL.
+ */
+Element getValue(KeyValuePair keyValuePair, const PairTraits *traits);
+
+/**
+ * Retrieves the key of the KeyValuePair without copying it.
+ * The key is borrowed: it still belongs to the pair, must not be freed,
+ * and is valid only until the pair is destroyed.
  *
  * @return The key element, or NULL if the KeyValuePair is NULL.
  */
-KeyValuePair getKey(KeyValuePair keyValuePair);
+Element borrowKey(KeyValuePair keyValuePair);
 
 /**
- * Retrieves the value from the KeyValuePair.
+ * Retrieves the value of the KeyValuePair without copying it.
+ * The value is borrowed, like the key returned by borrowKey.
+ *
+ * @return The value element, or NULL if the KeyValuePair is NULL.
+ */
+Element borrowValue(KeyValuePair keyValuePair);
+
+/**
+ * Retrieves the cached hash of the key.
  *
  * @param keyValuePair - The KeyValuePair to query.
  *
- * @return The value element, or NULL if the KeyValuePair is NULL.
+ * @return The hash given at creation, or 0 if the KeyValuePair is NULL.
+ */
+unsigned long long getKeyHash(KeyValuePair keyValuePair);
+
+/**
+ * Gets the size of the block every KeyValuePair is allocated in, to size a pool for them.
+ *
+ * @return The size of a KeyValuePair, in bytes.
  */
-KeyValuePair getValue(KeyValuePair keyValuePair);
+size_t getKeyValuePairSize(void);
 
 /**
  * Checks if the key in a KeyValuePair matches a given key element.
  *
  * @param a - The KeyValuePair to query.
  * @param b - The key element to compare against.
+ * @param traits - The traits the pair was created with.
  *
  * @return `true` if the keys are equal, `false` otherwise.
  *
  * Notes:
- * - Uses the compare function provided during KeyValuePair creation.
+ * - Uses traits->compareKey.
  * - Returns `false` if either the KeyValuePair or the key is NULL.
  */
-bool isEqualkey(KeyValuePair a, Element b);
+bool isEqualkey(KeyValuePair a, Element b, const PairTraits *traits);
 
 /**
  * Displays both the key and value of a KeyValuePair.
  *
- * @param keyValuePair - The KeyValuePair to display.
- *
  * @return `success` if both the key and value were displayed, `failure` otherwise.
  *
  * Notes:
  * - Calls `displayKey` and `displayValue` internally.
  * - Failure of either operation results in a `failure` return value.
  */
-status displaypair(KeyValuePair keyValuePair);
+status displaypair(KeyValuePair keyValuePair, const PairTraits *traits);
+
+/**
+ * Retrieves the pair that follows this one in its chain.
+ * Pairs carry a single link so that a hash table bucket can chain them
+ * without separately allocated list nodes.
+ *
+ * @return The next pair, or NULL at the end of the chain.
+ */
+KeyValuePair getNextPair(KeyValuePair keyValuePair);
+
+/**
+ * Sets the pair that follows this one in its chain.
+ *
+ * @return `success`, or `failure` if the KeyValuePair is NULL.
+ */
+status setNextPair(KeyValuePair keyValuePair, KeyValuePair next);
 
 #endif //KEYVALUEPAIR_H
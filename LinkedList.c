@@ -5,20 +5,23 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Node structure: contains data and a pointer to the next node
+// Node structure: contains data and pointers to the neighbouring nodes
 typedef struct node_h{
     Element data; // Data stored in the node
     struct node_h * next; // Pointer to the next node
+    struct node_h * prev; // Pointer to the previous node
 }Node;
 
-// LinkedList structure: manages the head node, size, and function pointers
+// LinkedList structure: manages the head and tail nodes, size, and function pointers
 typedef struct List_h {
     Node * head; // Pointer to the head node
+    Node * tail; // Pointer to the last node, for constant time appends
     int size; // Number of elements in the list
     CopyFunction copy_func; // Function pointer for copying elements
     FreeFunction free_func; // Function pointer for freeing elements
     EqualFunction cmp_func; // Function pointer for comparing elements
     PrintFunction print_func; // Function pointer for printing elements
+    const Allocator *allocator; // Source of the nodes, NULL for malloc
 }LinkedList;
 
 // Function to create a new linked list
@@ -34,11 +37,22 @@ linkedlist createLinkedList(CopyFunction copy_func, FreeFunction free_func, Equa
     list->free_func = free_func;
     list->cmp_func = cmp_func;
     list->print_func = print_func;
+    list->allocator = NULL;
     list->size = 0;
     list->head = NULL; // Initialize the list as empty
+    list->tail = NULL;
     return list;
 };
 
+// Function to make a list allocate its nodes from an allocator
+status setListAllocator(linkedlist list, const Allocator *allocator) {
+    if (!list || list->size > 0) {
+        return failure; // Existing nodes came from the previous allocator
+    }
+    list->allocator = allocator;
+    return success;
+}
+
 // Function to create a new node with given data
 Node *createNode(Element data, linkedlist List) {
     if (!data) {
@@ -47,16 +61,17 @@ Node *createNode(Element data, linkedlist List) {
     if (List == NULL) {
         return NULL; // Ensure the list is valid
     }
-    Node *node = malloc(sizeof(Node));
+    Node *node = allocateBlock(List->allocator, sizeof(Node));
     if (!node) {
         return NULL; // Memory allocation failed
     }
     node->data = List->copy_func(data); // Copy data using the provided function
     if (node->data == NULL) {
-        free(node); // Free node if data copy fails
+        releaseBlock(List->allocator, node, sizeof(Node)); // Free node if data copy fails
         return NULL;
     }
     node->next = NULL; // Initialize next pointer to NULL
+    node->prev = NULL; // Initialize prev pointer to NULL
     return node;
 }
 
@@ -76,35 +91,57 @@ status destroyList(linkedlist List) {
         Node *temp = current;
         current = current->next;
         list->free_func(temp->data); // Free the data in the node
-        free(temp); // Free the node itself
+        releaseBlock(list->allocator, temp, sizeof(Node)); // Free the node itself
     }
     list->head = NULL; // Set the head to NULL
+    list->tail = NULL; // Set the tail to NULL
     list->size = 0; // Reset the size
     free(list); // Free the list structure
     return success;
 }
 
-// Function to append a new node with data to the end of the list
-status appendNode(linkedlist list, Element data) {
-    if (!list) return failure; // Ensure the list is valid
-    if (!data) return failure; // Ensure the data is valid
+// Function to unlink a node from the list and free it with its data
+static void unlinkNode(linkedlist list, Node *node) {
+    if (node->prev) {
+        node->prev->next = node->next; // Bypass the node from the left
+    } else {
+        list->head = node->next; // The node was the head
+    }
+    if (node->next) {
+        node->next->prev = node->prev; // Bypass the node from the right
+    } else {
+        list->tail = node->prev; // The node was the tail
+    }
+    list->free_func(node->data); // Free the data in the node
+    releaseBlock(list->allocator, node, sizeof(Node)); // Free the node itself
+    list->size--;
+}
+
+// Function to append a new node with data to the end of the list and return it
+listNode appendNodeWithHandle(linkedlist list, Element data) {
+    if (!list) return NULL; // Ensure the list is valid
+    if (!data) return NULL; // Ensure the data is valid
 
     Node *new_node = createNode(data, list);
     if (!new_node) {
-        return failure; // Node creation failed
+        return NULL; // Node creation failed
     }
-    if (!list->head) {
+    if (!list->tail) {
         list->head = new_node; // Set as head if the list is empty
-        list->size++;
-        return success;
-    }
-    Node *current = list->head;
-    while (current->next != NULL) {
-        current = current->next; // Traverse to the last node
+    } else {
+        new_node->prev = list->tail;
+        list->tail->next = new_node; // Append the new node after the tail
     }
-
-    current->next = new_node; // Append the new node to the end
+    list->tail = new_node;
     list->size++;
+    return new_node;
+}
+
+// Function to append a new node with data to the end of the list
+status appendNode(linkedlist list, Element data) {
+    if (appendNodeWithHandle(list, data) == NULL) {
+        return failure; // Invalid input or node creation failed
+    }
     return success;
 }
 
@@ -112,26 +149,11 @@ status appendNode(linkedlist list, Element data) {
 status deleteNode(linkedlist list, Element data) {
     if (!list) return failure; // Ensure the list is valid
     if (!data) return failure; // Ensure the data is valid
-    if (!list->head) {
-        return failure; // List is empty
-    }
-    if (list->cmp_func(list->head->data, data)) {
-        Node *temp = list->head;
-        list->head = list->head->next; // Update the head to the next node
-        list->free_func(temp->data); // Free the data in the node
-        free(temp); // Free the node itself
-        list->size--;
-        return success;
-    }
 
     Node *current = list->head;
-    for (int i = 0; i < list->size - 1; i++) { // Traverse until the second-to-last node
-        Node *temp = current->next;
-        if (list->cmp_func(temp->data, data)) {
-            current->next = temp->next; // Remove the node from the list
-            list->free_func(temp->data); // Free the data in the node
-            free(temp); // Free the node itself
-            list->size--;
+    while (current) {
+        if (list->cmp_func(current->data, data)) {
+            unlinkNode(list, current); // Remove the first matching node
             return success;
         }
         current = current->next;
@@ -139,6 +161,33 @@ status deleteNode(linkedlist list, Element data) {
     return failure; // Node not found
 }
 
+// Function to remove a node using the handle returned when it was appended
+status removeNodeByHandle(linkedlist list, listNode node) {
+    if (!list || !node) {
+        return failure; // Ensure the list and node are valid
+    }
+    unlinkNode(list, node);
+    return success;
+}
+
+// Function to detach the head node and hand its data to the caller
+Element detachFirstNode(linkedlist list) {
+    if (!list || !list->head) {
+        return NULL; // Invalid or empty list
+    }
+    Node *node = list->head;
+    Element data = node->data;
+    list->head = node->next;
+    if (list->head) {
+        list->head->prev = NULL;
+    } else {
+        list->tail = NULL; // The list is now empty
+    }
+    releaseBlock(list->allocator, node, sizeof(Node)); // Free the node but keep its data
+    list->size--;
+    return data;
+}
+
 // Function to print the linked list
 status printList(linkedlist list) {
     if (!list || list->size == 0) {
@@ -162,6 +211,15 @@ status printList(linkedlist list) {
 
 // Function to get a copy of the data at a specific index in the list
 Element getDataByIndex(linkedlist list, int index) {
+    Element data = borrowDataByIndex(list, index);
+    if (!data) {
+        return NULL; // Invalid list or index
+    }
+    return list->copy_func(data); // Return a copy of the data
+}
+
+// Function to get the data at an index without copying it
+Element borrowDataByIndex(linkedlist list, int index) {
     if (!list || index < 0 || index >= list->size) {
         return NULL; // Check if the list is valid and index is within bounds
     }
@@ -173,7 +231,7 @@ Element getDataByIndex(linkedlist list, int index) {
     for (int i = 0; i < index; i++) {
         current = current->next; // Traverse to the desired index
     }
-    return list->copy_func(current->data); // Return a copy of the data
+    return current->data; // Return the data itself
 }
 
 // Function to get the length of the list
@@ -182,8 +240,22 @@ int getLengthList(linkedlist list) {
     return list->size; // Return the size of the list
 }
 
+// Function to get the size of a node block
+size_t getListNodeSize(void) {
+    return sizeof(Node);
+}
+
 // Function to search for an element in the list by key
 Element searchByKeyInList(linkedlist list, Element key) {
+    Element data = borrowByKeyInList(list, key);
+    if (!data) {
+        return NULL; // Key not found
+    }
+    return list->copy_func(data); // Return a copy of the matching data
+}
+
+// Function to search for an element in the list by key without copying it
+Element borrowByKeyInList(linkedlist list, Element key) {
     if (!key) {
         return NULL;
     }
@@ -192,9 +264,59 @@ Element searchByKeyInList(linkedlist list, Element key) {
     Node *current = list->head;
     while (current) {
         if (list->cmp_func(current->data, key)) {
-            return list->copy_func(current->data); // Return a copy of the matching data
+            return current->data; // Return the matching data itself
         }
         current = current->next; // Move to the next node
     }
     return NULL; // Key not found
 }
+
+// Function to get the first node of the list
+listNode listBegin(linkedlist list) {
+    if (!list) return NULL; // Ensure the list is valid
+    return list->head;
+}
+
+// Function to advance to the next node
+listNode listNext(listNode node) {
+    if (!node) return NULL; // Already at the end
+    return node->next;
+}
+
+// Function to get the end position of the list
+listNode listEnd(linkedlist list) {
+    (void)list; // Accepted for symmetry with listBegin, not read
+    return NULL; // The end is always one past the last node
+}
+
+// Function to get a copy of the data stored in a node
+Element getDataByNode(linkedlist list, listNode node) {
+    if (!list || !node) {
+        return NULL; // Check if the list and node are valid
+    }
+    return list->copy_func(node->data); // Return a copy of the data
+}
+
+// Function to get the data stored in a node without copying it
+Element borrowDataByNode(linkedlist list, listNode node) {
+    if (!list || !node) {
+        return NULL; // Check if the list and node are valid
+    }
+    return node->data; // Return the data itself
+}
+
+// Function to visit every element of the list until the visitor asks to stop
+status forEachInList(linkedlist list, VisitFunction visit, Element context) {
+    if (!list || !visit) {
+        return failure; // Ensure the list and visitor are valid
+    }
+    Node *current = list->head;
+    while (current) {
+        Node *next = current->next; // Save the next node before visiting the current one
+        if (!visit(current->data, context)) {
+            break; // The visitor asked to stop
+        }
+        current = next;
+    }
+    return success;
+}
@@ -5,6 +5,7 @@
 #ifndef LINKEDLIST_H
 #define LINKEDLIST_H
 #include "Defs.h"
+#include "Allocator.h"
 /**
  * @file linkedlist.h
  * @brief Interface for a generic linked list.
@@ -13,6 +14,17 @@
 /** A type for a linked list handle. */
 typedef struct List_h* linkedlist;
 
+/** A type for a position (node) inside a linked list, used for iteration and as a removal handle. */
+typedef struct node_h* listNode;
+
+/**
+ * @brief A visitor called for each element during a traversal.
+ * @param data The element stored in the current node (not a copy).
+ * @param context Caller supplied state passed through unchanged.
+ * @return true to continue the traversal, false to stop it early.
+ */
+typedef bool(*VisitFunction) (Element data, Element context);
+
 /**
  * @brief Creates a new linked list.
  * @param copy_func A function pointer for copying elements.
@@ -23,6 +35,15 @@ typedef struct List_h* linkedlist;
  */
 linkedlist createLinkedList(CopyFunction copy_func, FreeFunction free_func, EqualFunction cmp_func, PrintFunction print_func);
 
+/**
+ * @brief Makes a list allocate its nodes from an allocator instead of malloc.
+ * Must be called while the list is empty.
+ * @param list The linked list.
+ * @param allocator The allocator, which must outlive the list, or NULL for malloc.
+ * @return Status of the operation (success or failure).
+ */
+status setListAllocator(linkedlist list, const Allocator *allocator);
+
 /**
  * @brief Destroys the linked list and frees all allocated memory.
  * Frees the memory for each node and its data, as well as the linked list itself.
@@ -33,13 +54,24 @@ status destroyList(linkedlist List);
 
 /**
  * @brief Appends a new node with the given data to the linked list.
- * Adds the data to the end of the list by creating a new node.
+ * Adds the data to the end of the list by creating a new node, in constant time.
  * @param List The linked list.
  * @param data The data to add. This data is copied into the list.
  * @return Status of the operation (success or failure).
  */
 status appendNode(linkedlist List, Element data);
 
+/**
+ * @brief Appends a new node with the given data and returns a handle to it.
+ * Works like appendNode, in constant time, but the returned node can later be
+ * passed to removeNodeByHandle to remove the element without searching for it.
+ * The handle stays valid until its node is removed or the list is destroyed.
+ * @param List The linked list.
+ * @param data The data to add. This data is copied into the list.
+ * @return A handle to the new node, or NULL if the operation failed.
+ */
+listNode appendNodeWithHandle(linkedlist List, Element data);
+
 /**
  * @brief Deletes a node with the specified data from the linked list.
  * Removes the first node containing the specified data.
@@ -50,6 +82,24 @@ status appendNode(linkedlist List, Element data);
  */
 status deleteNode(linkedlist List, Element data);
 
+/**
+ * @brief Removes a node using the handle returned by appendNodeWithHandle.
+ * Unlinks the node in constant time and frees its data with the list's free function.
+ * @param List The linked list the node belongs to.
+ * @param node The handle of the node to remove.
+ * @return Status of the operation (success or failure).
+ */
+status removeNodeByHandle(linkedlist List, listNode node);
+
+/**
+ * @brief Detaches the first node of the linked list and returns its data.
+ * The node is freed but its data is not: ownership moves to the caller.
+ * Useful for moving elements from one list to another without copying them.
+ * @param List The linked list.
+ * @return The data of the first node, or NULL if the list is empty or invalid.
+ */
+Element detachFirstNode(linkedlist List);
+
 /**
  * @brief Prints the linked list.
  * Traverses the list and prints each element using the provided print function.
@@ -67,6 +117,17 @@ status printList(linkedlist List);
  */
 Element getDataByIndex(linkedlist List, int index);
 
+/**
+ * @brief Gets the data of a node by its index without copying it.
+ * Like getDataByIndex, but the element itself is returned, so no copy function runs.
+ * The element is borrowed: it still belongs to the list, must not be freed, and is
+ * valid only until it is removed from the list or the list is destroyed.
+ * @param List The linked list.
+ * @param index The index of the node (0-based).
+ * @return The data of the node, or NULL if the index is invalid or the list is empty.
+ */
+Element borrowDataByIndex(linkedlist List, int index);
+
 /**
  * @brief Gets the length of the linked list.
  * Returns the number of nodes currently in the list.
@@ -75,6 +136,12 @@ Element getDataByIndex(linkedlist List, int index);
  */
 int getLengthList(linkedlist List);
 
+/**
+ * @brief Gets the size of the block every node is allocated in, to size a pool for them.
+ * @return The size of a node, in bytes.
+ */
+size_t getListNodeSize(void);
+
 /**
  * @brief Searches for a node by key in the linked list.
  * Traverses the list and returns a copy of the data for the first node that matches the key.
@@ -85,4 +152,65 @@ int getLengthList(linkedlist List);
  */
 Element searchByKeyInList(linkedlist List, Element key);
 
+/**
+ * @brief Searches for a node by key in the linked list without copying its data.
+ * Like searchByKeyInList, but returns the borrowed element itself (see borrowDataByIndex).
+ * @param List The linked list.
+ * @param key The key to search for.
+ * @return The matching element, or NULL if no match is found.
+ */
+Element borrowByKeyInList(linkedlist List, Element key);
+
+/**
+ * @brief Gets the first position of the linked list.
+ * Together with listNext and listEnd this allows a single forward pass
+ * over the list instead of repeated getDataByIndex calls.
+ * @param List The linked list.
+ * @return The first node, or listEnd(List) if the list is empty or invalid.
+ */
+listNode listBegin(linkedlist List);
+
+/**
+ * @brief Advances to the next position of the linked list.
+ * @param node The current position.
+ * @return The following node, or listEnd if node was the last one.
+ */
+listNode listNext(listNode node);
+
+/**
+ * @brief Gets the position one past the last node of the linked list.
+ * The end is NULL for every list, so a loop may also stop at NULL directly.
+ * @param List The linked list, accepted for symmetry with listBegin and not read.
+ * @return The end position (NULL).
+ */
+listNode listEnd(linkedlist List);
+
+/**
+ * @brief Gets the data stored at a position of the linked list.
+ * Returns a copy of the data, the same way getDataByIndex does.
+ * @param List The linked list the node belongs to.
+ * @param node The position.
+ * @return A copy of the node's data, or NULL if the node is invalid.
+ */
+Element getDataByNode(linkedlist List, listNode node);
+
+/**
+ * @brief Gets the data stored at a position of the linked list without copying it.
+ * Like getDataByNode, but returns the borrowed element itself (see borrowDataByIndex).
+ * @param List The linked list the node belongs to.
+ * @param node The position.
+ * @return The node's data, or NULL if the node is invalid.
+ */
+Element borrowDataByNode(linkedlist List, listNode node);
+
+/**
+ * @brief Calls a visitor on each element of the list, in order.
+ * The traversal stops as soon as the visitor returns false.
+ * @param List The linked list.
+ * @param visit The visitor to call for each element.
+ * @param context Caller supplied state passed to every visitor call.
+ * @return Status of the operation (success or failure).
+ */
+status forEachInList(linkedlist List, VisitFunction visit, Element context);
+
 #endif //LINKEDLIST_H
@@ -3,41 +3,85 @@
 //
 #include "HashTable.h"
 #include "LinkedList.h"
+#include "OrderedIndex.h"
 #include "MultiValueHashTable.h"
 #include "Defs.h"
 
 // Structure definition for MultiValueHashTable
 typedef struct multihashTable_s {
-    hashTable table; ///< The hash table used to store keys and lists of values
+    hashTable table; ///< The hash table used to store keys and the value sets of the keys
     PrintFunction printValue; ///< Function to print values in the lists
     PrintFunction printKey;
     FreeFunction freeValue; ///< Function to free values in the lists
     CopyFunction copyValue; ///< Function to copy values in the lists
     EqualFunction equalValue; ///< Function to compare values in the lists
+    ScoreFunction scoreValue; ///< Function to score values, NULL when the values are not ordered
+    const Allocator *allocator; ///< Source of the pairs, value sets, list nodes and index entries, NULL for malloc
 } MultiValueHashTable;
 
-// Helper function to copy a linked list
-Element copylist(Element list) {
-    linkedlist newlist = (linkedlist)list;
-    return newlist;
+// The values of one key: a list in insertion order, and optionally an index in score order
+typedef struct {
+    linkedlist values; ///< The values, in insertion order
+    orderedIndex order; ///< Entries holding the list nodes, in score order; NULL if the table is not scored
+    runningAggregate scores; ///< Aggregate of the scores of the values, kept when the table is scored
+    const Allocator *allocator; ///< Allocator the set came from
+} ValueSet;
+
+// Helper function to copy a value set (the set itself is shared, not duplicated)
+static Element copyValueSet(Element set) {
+    return set;
+}
+
+// Helper function to destroy a value set
+static status destroyValueSet(Element set) {
+    if (set == NULL) {
+        return failure; // Check if the set is NULL
+    }
+    ValueSet *valueSet = (ValueSet *)set;
+    if (valueSet->order) {
+        destroyOrderedIndex(valueSet->order); // The index only refers to the list nodes
+    }
+    status s = destroyList(valueSet->values); // Destroy the list
+    releaseBlock(valueSet->allocator, valueSet, sizeof(ValueSet));
+    return s;
 }
 
-// Helper function to destroy a linked list
-status destroyList1(Element list) {
-    if (list == NULL) {
-        return failure; // Check if the list is NULL
+// Helper function to print a value set
+static status printValueSet(Element set) {
+    if (set == NULL) {
+        return failure; // Check if the set is NULL
     }
-    linkedlist newlist = (linkedlist)list;
-    return destroyList(newlist); // Destroy the list
+    return printList(((ValueSet *)set)->values); // Print the list
 }
 
-// Helper function to print a linked list
-status printList1(Element list) {
-    if (list == NULL) {
-        return failure; // Check if the list is NULL
+// Helper function to create the empty value set of a new key (called on a lookup miss only)
+static Element newValueList(Element multiHashTable) {
+    MultiValueHashTable *table = (MultiValueHashTable *)multiHashTable;
+    ValueSet *set = allocateBlock(table->allocator, sizeof(ValueSet));
+    if (set == NULL) {
+        return NULL; // Memory allocation failed
+    }
+    set->allocator = table->allocator;
+    set->values = createLinkedList(table->copyValue, table->freeValue, table->equalValue, table->printValue);
+    set->order = NULL;
+    resetAggregate(&set->scores);
+    if (set->values) {
+        setListAllocator(set->values, table->allocator);
+    }
+    if (set->values && table->scoreValue) {
+        set->order = createOrderedIndex();
+        if (set->order == NULL) {
+            destroyList(set->values); // Index allocation failed
+            set->values = NULL;
+        } else {
+            setOrderedIndexAllocator(set->order, table->allocator);
+        }
+    }
+    if (set->values == NULL) {
+        releaseBlock(set->allocator, set, sizeof(ValueSet)); // List allocation failed
+        return NULL;
     }
-    linkedlist newlist = (linkedlist)list;
-    return printList(newlist); // Print the list
+    return set;
 }
 
 // Create a MultiValueHashTable
@@ -49,8 +93,8 @@ multiValueHashTable createMultiValueHashTable(CopyFunction copyKey, FreeFunction
     if (multiHashTable == NULL) {
         return NULL; // Return NULL if memory allocation fails
     }
-    multiHashTable->table = createHashTable(copyKey, freeKey, printKey, copylist,
-                                            destroyList1, printList1, equalKey, transformIntoNumber, hashNumber);
+    multiHashTable->table = createHashTable(copyKey, freeKey, printKey, copyValueSet,
+                                            destroyValueSet, printValueSet, equalKey, transformIntoNumber, hashNumber);
     if (multiHashTable->table == NULL) {
         free(multiHashTable); // Free MultiValueHashTable if HashTable creation fails
         return NULL;
@@ -60,6 +104,8 @@ multiValueHashTable createMultiValueHashTable(CopyFunction copyKey, FreeFunction
     multiHashTable->copyValue = copyValue;
     multiHashTable->equalValue = equalValue;
     multiHashTable->printKey = printKey;
+    multiHashTable->scoreValue = NULL;
+    multiHashTable->allocator = NULL;
     return multiHashTable;
 }
 
@@ -74,25 +120,58 @@ status destroyMultiValueHashTable(multiValueHashTable multiHashTable) {
     return success;
 }
 
+// Order the values of every key by a score, while the table is still empty
+status setMultiValueScoreFunction(multiValueHashTable multiHashTable, ScoreFunction scoreValue) {
+    if (multiHashTable == NULL || scoreValue == NULL || getHashTableCount(multiHashTable->table) != 0) {
+        return failure; // Existing keys would have no ordered index
+    }
+    multiHashTable->scoreValue = scoreValue;
+    return success;
+}
+
+// Make the table allocate its pairs, value sets, list nodes and index entries from an allocator
+status setMultiValueAllocator(multiValueHashTable multiHashTable, const Allocator *allocator) {
+    if (multiHashTable == NULL || setHashTableAllocator(multiHashTable->table, allocator) == failure) {
+        return failure; // The table already holds keys
+    }
+    multiHashTable->allocator = allocator;
+    return success;
+}
+
 // Add a value to the MultiValueHashTable for a specific key
 status addToMultiValueHashTable(multiValueHashTable multiHashTable, Element key, Element value) {
+    if (addToMultiValueHashTableWithHandle(multiHashTable, key, value) == NULL) {
+        return failure;
+    }
+    return success;
+}
+
+// Add a value for a specific key and return the handle of its entry
+multiValueEntry addToMultiValueHashTableWithHandle(multiValueHashTable multiHashTable, Element key, Element value) {
     if (multiHashTable == NULL || key == NULL || value == NULL) {
-        return failure; // Check for NULL inputs
+        return NULL; // Check for NULL inputs
     }
-    linkedlist existingList = (linkedlist)lookupInHashTable(multiHashTable->table, key);
-    if (existingList == NULL) {
-        linkedlist newList = createLinkedList(multiHashTable->copyValue, multiHashTable->freeValue,
-                                              multiHashTable->equalValue, multiHashTable->printValue);
-        if (newList == NULL) {
-            return failure; // Return failure if list creation fails
-        }
-        if (addToHashTable(multiHashTable->table, key, newList) == failure) {
-            destroyList(newList); // Free the list if adding fails
-            return failure;
+    bool inserted = false;
+    ValueSet *set = (ValueSet *)findOrInsertInHashTable(multiHashTable->table, key, newValueList,
+                                                         multiHashTable, &inserted); // One probe for both cases
+    if (set == NULL) {
+        return NULL; // Return NULL if list creation fails
+    }
+    listNode node = appendNodeWithHandle(set->values, value);
+    multiValueEntry entry = (multiValueEntry)node;
+    if (node && set->order) {
+        double score = multiHashTable->scoreValue(key, value);
+        entry = (multiValueEntry)insertInOrderedIndex(set->order, score, node);
+        if (entry == NULL) {
+            removeNodeByHandle(set->values, node); // Keep the list and the index in step
+        } else {
+            addToAggregate(&set->scores, score);
         }
-        return appendNode(newList, value); // Add the value to the new list
     }
-    return appendNode(existingList, value); // Add the value to the existing list
+    if (entry == NULL && inserted) {
+        removeFromHashTable(multiHashTable->table, key); // Do not keep a key without values
+    }
+    return entry;
 }
 
 // Lookup a list of values in the MultiValueHashTable by key
@@ -100,14 +179,29 @@ linkedlist lookupInMultiValueHashTable(multiValueHashTable multiHashTable, Eleme
     if (multiHashTable == NULL || key == NULL) {
         return NULL; // Check for NULL inputs
     }
-    if (lookupInHashTable(multiHashTable->table, key) == NULL) {
+    ValueSet *set = (ValueSet *)borrowFromHashTable(multiHashTable->table, key);
+    if (set == NULL) {
         return NULL; // Return NULL if key is not found
     }
-    linkedlist existingList = (linkedlist)lookupInHashTable(multiHashTable->table, key);
-    if (existingList == NULL) {
-        return NULL; // Return NULL if no list exists for the key
+    return set->values;
+}
+
+// Remove the key once its last value is gone
+static void dropKeyIfEmpty(multiValueHashTable multiHashTable, Element key, ValueSet *set) {
+    if (getLengthList(set->values) == 0) {
+        removeFromHashTable(multiHashTable->table, key); // Remove the key if the list is empty
+    }
+}
+
+// Remove an ordered entry and the list node it refers to
+static status removeOrderedEntry(ValueSet *set, orderedEntry entry) {
+    listNode node = (listNode)getOrderedData(entry);
+    double score = getOrderedScore(entry);
+    if (removeFromOrderedIndex(set->order, entry) == failure) {
+        return failure; // The entry is not in this set
     }
-    return existingList;
+    removeFromAggregate(&set->scores, score);
+    return removeNodeByHandle(set->values, node);
 }
 
 // Remove a specific value for a key in the MultiValueHashTable
@@ -115,14 +209,107 @@ status removeFromMultiValueHashTable(multiValueHashTable multiHashTable, Element
     if (multiHashTable == NULL || key == NULL) {
         return failure; // Check for NULL inputs
     }
-    linkedlist existingList = (linkedlist)lookupInHashTable(multiHashTable->table, key);
-    if (!existingList) {
+    ValueSet *set = (ValueSet *)borrowFromHashTable(multiHashTable->table, key);
+    if (!set) {
         return failure; // Return failure if the key does not exist
     }
-    deleteNode(existingList, val); // Remove the value from the list
-    if (getLengthList(existingList) == 0) {
-        removeFromHashTable(multiHashTable->table, key); // Remove the key if the list is empty
+    status s = failure; // Until the value is found
+    if (set->order == NULL) {
+        s = deleteNode(set->values, val); // Remove the value from the list
+    } else {
+        double score = multiHashTable->scoreValue(key, val); // Only the entries with this score can match
+        for (orderedEntry entry = ceilingInOrderedIndex(set->order, score);
+             entry != NULL && getOrderedScore(entry) == score; entry = orderedNext(entry)) {
+            if (multiHashTable->equalValue(borrowDataByNode(set->values, (listNode)getOrderedData(entry)), val)) {
+                s = removeOrderedEntry(set, entry);
+                break;
+            }
+        }
+    }
+    if (s == failure) {
+        return failure; // The value is not in the key's list
+    }
+    dropKeyIfEmpty(multiHashTable, key, set);
+    return success;
+}
+
+// Remove a value of a key using its entry handle
+status removeFromMultiValueHashTableByHandle(multiValueHashTable multiHashTable, Element key, multiValueEntry entry) {
+    if (multiHashTable == NULL || key == NULL || entry == NULL) {
+        return failure; // Check for NULL inputs
+    }
+    ValueSet *set = (ValueSet *)borrowFromHashTable(multiHashTable->table, key);
+    if (!set) {
+        return failure; // Return failure if the key does not exist
+    }
+    status s = set->order ? removeOrderedEntry(set, (orderedEntry)entry)
+                          : removeNodeByHandle(set->values, (listNode)entry);
+    if (s == failure) {
+        return failure;
+    }
+    dropKeyIfEmpty(multiHashTable, key, set);
+    return success;
+}
+
+// Find the value of a key whose score is nearest to a score
+Element nearestInMultiValueHashTable(multiValueHashTable multiHashTable, Element key, double score) {
+    if (multiHashTable == NULL || key == NULL) {
+        return NULL; // Check for NULL inputs
+    }
+    ValueSet *set = (ValueSet *)borrowFromHashTable(multiHashTable->table, key);
+    if (!set || !set->order) {
+        return NULL; // Unknown key, or a table whose values are not ordered
+    }
+    orderedEntry below = floorInOrderedIndex(set->order, score); // Nearest from below, first inserted on ties
+    orderedEntry above = higherInOrderedIndex(set->order, score); // Nearest from above, first inserted on ties
+    orderedEntry nearest = below;
+    if (below == NULL) {
+        nearest = above;
+    } else if (above != NULL) {
+        double belowDiff = score - getOrderedScore(below);
+        double aboveDiff = getOrderedScore(above) - score;
+        if (aboveDiff < belowDiff || (aboveDiff == belowDiff && orderedInsertedBefore(above, below))) {
+            nearest = above;
+        }
+    }
+    return borrowDataByNode(set->values, (listNode)getOrderedData(nearest));
+}
+
+// Visit the values of a key whose score lies in a range, in score order
+status forEachInMultiValueRange(multiValueHashTable multiHashTable, Element key, double low, double high,
+                                VisitFunction visit, Element context) {
+    if (multiHashTable == NULL || key == NULL || visit == NULL) {
+        return failure; // Check for NULL inputs
+    }
+    ValueSet *set = (ValueSet *)borrowFromHashTable(multiHashTable->table, key);
+    if (!set || !set->order) {
+        return failure; // Unknown key, or a table whose values are not ordered
+    }
+    orderedEntry entry = ceilingInOrderedIndex(set->order, low);
+    while (entry != NULL && getOrderedScore(entry) <= high) {
+        orderedEntry next = orderedNext(entry); // Save the next entry before visiting the current one
+        if (!visit(borrowDataByNode(set->values, (listNode)getOrderedData(entry)), context)) {
+            break; // The visitor asked to stop
+        }
+        entry = next;
+    }
+    return success;
+}
+
+// Get the aggregate of the scores of a key's values
+status getMultiValueStats(multiValueHashTable multiHashTable, Element key, runningAggregate *stats) {
+    if (multiHashTable == NULL || key == NULL || stats == NULL) {
+        return failure; // Check for NULL inputs
+    }
+    ValueSet *set = (ValueSet *)borrowFromHashTable(multiHashTable->table, key);
+    if (!set || !set->order) {
+        return failure; // Unknown key, or a table whose values are not ordered
+    }
+    if (set->scores.boundsStale) { // A bound was removed: the ends of the index hold the new ones
+        setAggregateBounds(&set->scores, getOrderedScore(orderedBegin(set->order)),
+                           getOrderedScore(orderedLast(set->order)));
     }
+    *stats = set->scores;
     return success;
 }
 
@@ -131,7 +318,7 @@ status displayMultiValueHashElementsByKey(multiValueHashTable multiHashTable, El
     if (multiHashTable == NULL) {
         return failure; // Check if the MultiValueHashTable is NULL
     }
-    linkedlist existingList = (linkedlist)lookupInHashTable(multiHashTable->table, key);
+    linkedlist existingList = lookupInMultiValueHashTable(multiHashTable, key);
     if (existingList == NULL) {
         return failure; // Return failure if the key does not exist
     }
@@ -5,6 +5,8 @@
 #ifndef MULTIVALUEHASHTABLE_H
 #define MULTIVALUEHASHTABLE_H
 #include "Defs.h"
+#include "LinkedList.h"
+#include "Aggregate.h"
 
 /**
  * @file MultiValueHashTable.h
@@ -17,6 +19,17 @@
  */
 typedef struct multihashTable_s *multiValueHashTable;
 
+/**
+ * Type definition for the handle of one value added to a MultiValueHashTable.
+ * It is opaque: it is only passed back to removeFromMultiValueHashTableByHandle.
+ */
+typedef struct multiValueEntry_s *multiValueEntry;
+
+/**
+ * Type definition for a function giving the score a value is ordered by under a key.
+ */
+typedef double(*ScoreFunction) (Element key, Element value);
+
 /**
  * @brief Creates a new MultiValueHashTable.
  * @param copyKey Function to copy keys.
@@ -26,7 +39,7 @@ typedef struct multihashTable_s *multiValueHashTable;
  * @param freeValue Function to free values.
  * @param printValue Function to print values.
  * @param equalKey Function to compare keys.
- * @param transformIntoNumber Function to hash keys into indices.
+ * @param transformIntoNumber Function to hash keys into indices, or NULL for the default string hash.
  * @param hashNumber Number of buckets in the hash table.
  * @param equalValue Function to compare values.
  * @return A pointer to the created MultiValueHashTable or NULL if creation fails.
@@ -43,6 +56,27 @@ multiValueHashTable createMultiValueHashTable(CopyFunction copyKey, FreeFunction
  */
 status destroyMultiValueHashTable(multiValueHashTable multiHashTable);
 
+/**
+ * @brief Keeps the values of every key ordered by a score, next to their insertion order.
+ * Each key then also holds an ordered index (see OrderedIndex.h), so the value nearest
+ * to a score is found in logarithmic time. The score of a value must not change while
+ * it is in the table. Must be called while the table is empty.
+ * @param multiHashTable The MultiValueHashTable.
+ * @param scoreValue Function giving the score of a value under a key.
+ * @return Status of the operation (success or failure).
+ */
+status setMultiValueScoreFunction(multiValueHashTable multiHashTable, ScoreFunction scoreValue);
+
+/**
+ * @brief Makes the table allocate its key/value pairs, value sets, list nodes and
+ * ordered-index entries from an allocator instead of malloc. Must be called while
+ * the table is empty.
+ * @param multiHashTable The MultiValueHashTable.
+ * @param allocator The allocator, which must outlive the table, or NULL for malloc.
+ * @return Status of the operation (success or failure).
+ */
+status setMultiValueAllocator(multiValueHashTable multiHashTable, const Allocator *allocator);
+
 /**
  * @brief Adds a value to the MultiValueHashTable for a specific key.
  * If the key does not exist, a new key is created with an associated list of values.
@@ -53,6 +87,18 @@ status destroyMultiValueHashTable(multiValueHashTable multiHashTable);
  */
 status addToMultiValueHashTable(multiValueHashTable multiHashTable, Element key, Element value);
 
+/**
+ * @brief Adds a value for a key, like addToMultiValueHashTable, and returns a handle to it.
+ * The handle can later be passed to removeFromMultiValueHashTableByHandle to remove the
+ * value in constant time instead of searching the key's list for it.
+ * The handle stays valid until the value is removed or the table is destroyed.
+ * @param multiHashTable The MultiValueHashTable.
+ * @param key The key to add the value to.
+ * @param value The value to add to the list associated with the key.
+ * @return A handle to the added value, or NULL if the operation failed.
+ */
+multiValueEntry addToMultiValueHashTableWithHandle(multiValueHashTable multiHashTable, Element key, Element value);
+
 /**
  * @brief Looks up the list of values associated with a specific key.
  * Returns the list directly (not a copy). Do not free the returned list.
@@ -68,10 +114,59 @@ linkedlist lookupInMultiValueHashTable(multiValueHashTable multiHashTable, Eleme
  * @param multiHashTable The MultiValueHashTable.
  * @param key The key whose value needs to be removed.
  * @param val The value to remove from the list associated with the key.
- * @return Status of the operation (success or failure).
+ * @return `success` if the value was removed, `failure` if the key or the value is not in the table.
  */
 status removeFromMultiValueHashTable(multiValueHashTable multiHashTable, Element key, Element val);
 
+/**
+ * @brief Removes a value using the handle returned by addToMultiValueHashTableWithHandle.
+ * Takes one hash probe to find the key's list and unlinks the value in constant time,
+ * however many values the key has. If the list becomes empty the key is removed too.
+ * @param multiHashTable The MultiValueHashTable.
+ * @param key The key the value was added to.
+ * @param entry The handle of the value to remove.
+ * @return Status of the operation (success or failure).
+ */
+status removeFromMultiValueHashTableByHandle(multiValueHashTable multiHashTable, Element key, multiValueEntry entry);
+
+/**
+ * @brief Finds the value of a key whose score is nearest to a score.
+ * Values at equal distance are resolved in favour of the one added first.
+ * Takes logarithmic time in the number of values of the key.
+ * @param multiHashTable The MultiValueHashTable, with a score function set.
+ * @param key The key whose values are searched.
+ * @param score The score to get close to.
+ * @return The nearest value (not a copy), or NULL if the key does not exist or the table has no score function.
+ */
+Element nearestInMultiValueHashTable(multiValueHashTable multiHashTable, Element key, double score);
+
+/**
+ * @brief Calls a visitor on each value of a key whose score lies in [low, high], in score order.
+ * Values with equal scores are visited in the order they were added. The traversal stops
+ * as soon as the visitor returns false. Takes logarithmic time to find the first value and
+ * constant time per visited value, so the whole list of the key is never scanned.
+ * @param multiHashTable The MultiValueHashTable, with a score function set.
+ * @param key The key whose values are visited.
+ * @param low The lowest score to visit.
+ * @param high The highest score to visit.
+ * @param visit The visitor, called with each value (not a copy) and the context.
+ * @param context Caller supplied state passed to every visitor call.
+ * @return Status of the operation: failure if the key does not exist or the table has no score function.
+ */
+status forEachInMultiValueRange(multiValueHashTable multiHashTable, Element key, double low, double high,
+                                VisitFunction visit, Element context);
+
+/**
+ * @brief Gets the aggregate of the scores of a key's values: count, sum and sum of
+ * squares are kept up to date by every addition and removal, and bounds made stale
+ * by a removal are read again from the ends of the key's ordered index. Takes
+ * constant time, or logarithmic time after such a removal.
+ * @param multiHashTable The MultiValueHashTable, with a score function set.
+ * @param key The key whose values are aggregated.
+ * @param stats Receives the aggregate.
+ * @return Status of the operation: failure if the key does not exist or the table has no score function.
+ */
+status getMultiValueStats(multiValueHashTable multiHashTable, Element key, runningAggregate *stats);
 /**
  * @brief Displays all values associated with a specific key in the MultiValueHashTable.
  * Prints the values in the list associated with the key.
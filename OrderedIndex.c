@@ -0,0 +1,271 @@
+#include "OrderedIndex.h"
+
+// Highest level of the skip list: enough for 4^16 entries at the branching below
+#define MAX_LEVEL 16
+
+// Skip list node: one forward pointer per level it takes part in
+typedef struct orderedNode_s {
+    double score; // Score the entry is ordered by
+    unsigned long long seq; // Insertion number, orders entries with equal scores
+    Element data; // Element stored in the entry (not owned)
+    int level; // Number of levels the node takes part in
+    struct orderedNode_s *next[]; // Following node on each level
+} OrderedNode;
+
+// Ordered index structure: a head node linking the first node of every level
+typedef struct orderedIndex_s {
+    OrderedNode *head; // Sentinel before the first entry, on all levels
+    int level; // Number of levels currently in use
+    int size; // Number of entries
+    unsigned long long seq; // Insertion number of the next entry
+    unsigned long long random; // State of the level generator
+    const Allocator *allocator; // Source of the entry nodes, NULL for malloc (the head always comes from malloc)
+} OrderedIndex;
+
+// Size of a node taking part in the given number of levels
+static size_t nodeSize(int level) {
+    return sizeof(OrderedNode) + level * sizeof(OrderedNode *);
+}
+
+// Allocate a node taking part in the given number of levels
+static OrderedNode *createOrderedNode(const Allocator *allocator, int level) {
+    OrderedNode *node = allocateBlock(allocator, nodeSize(level));
+    if (!node) {
+        return NULL; // Memory allocation failed
+    }
+    node->level = level;
+    for (int i = 0; i < level; i++) {
+        node->next[i] = NULL;
+    }
+    return node;
+}
+
+// Draw the level of a new node: each level is kept with probability 1/4
+static int randomLevel(OrderedIndex *index) {
+    index->random ^= index->random << 13; // xorshift64
+    index->random ^= index->random >> 7;
+    index->random ^= index->random << 17;
+    unsigned long long bits = index->random;
+    int level = 1;
+    while (level < MAX_LEVEL && (bits & 3) == 0) {
+        level++;
+        bits >>= 2;
+    }
+    return level;
+}
+
+// Check whether a node comes before the position (score, seq)
+static bool before(OrderedNode *node, double score, unsigned long long seq) {
+    return node->score < score || (node->score == score && node->seq < seq);
+}
+
+// Find the last node before (score, seq) on every level
+static OrderedNode *findBefore(OrderedIndex *index, double score, unsigned long long seq,
+                               OrderedNode *update[MAX_LEVEL]) {
+    OrderedNode *node = index->head;
+    for (int i = index->level - 1; i >= 0; i--) {
+        while (node->next[i] && before(node->next[i], score, seq)) {
+            node = node->next[i];
+        }
+        if (update) {
+            update[i] = node;
+        }
+    }
+    return node; // The last node before the position on the bottom level
+}
+
+// Function to create a new ordered index
+orderedIndex createOrderedIndex(void) {
+    OrderedIndex *index = malloc(sizeof(OrderedIndex));
+    if (!index) {
+        return NULL; // Memory allocation failed
+    }
+    index->head = createOrderedNode(NULL, MAX_LEVEL);
+    if (!index->head) {
+        free(index); // Free the index if the head allocation fails
+        return NULL;
+    }
+    index->level = 1;
+    index->size = 0;
+    index->seq = 0;
+    index->random = 0x9e3779b97f4a7c15ULL;
+    index->allocator = NULL;
+    return index;
+}
+
+// Function to destroy an ordered index
+status destroyOrderedIndex(orderedIndex index) {
+    if (!index) {
+        return failure; // Ensure the index is valid
+    }
+    OrderedNode *node = index->head->next[0];
+    while (node) {
+        OrderedNode *next = node->next[0]; // Save the next node before freeing the current one
+        releaseBlock(index->allocator, node, nodeSize(node->level));
+        node = next;
+    }
+    free(index->head);
+    free(index);
+    return success;
+}
+
+// Function to make the index allocate its entries from an allocator
+status setOrderedIndexAllocator(orderedIndex index, const Allocator *allocator) {
+    if (!index || index->size > 0) {
+        return failure; // Existing entries came from the previous allocator
+    }
+    index->allocator = allocator;
+    return success;
+}
+
+// Function to insert an element with a score
+orderedEntry insertInOrderedIndex(orderedIndex index, double score, Element data) {
+    if (!index) {
+        return NULL; // Ensure the index is valid
+    }
+    OrderedNode *update[MAX_LEVEL];
+    unsigned long long seq = index->seq;
+    findBefore(index, score, seq, update); // Every existing entry comes before a new one with the same score
+    OrderedNode *node = createOrderedNode(index->allocator, randomLevel(index));
+    if (!node) {
+        return NULL; // Memory allocation failed
+    }
+    node->score = score;
+    node->seq = seq;
+    node->data = data;
+    for (int i = index->level; i < node->level; i++) {
+        update[i] = index->head; // New levels start at the head
+    }
+    if (node->level > index->level) {
+        index->level = node->level;
+    }
+    for (int i = 0; i < node->level; i++) {
+        node->next[i] = update[i]->next[i]; // Link the node on each of its levels
+        update[i]->next[i] = node;
+    }
+    index->seq++;
+    index->size++;
+    return node;
+}
+
+// Function to remove an entry by its handle
+status removeFromOrderedIndex(orderedIndex index, orderedEntry entry) {
+    if (!index || !entry) {
+        return failure; // Ensure the index and entry are valid
+    }
+    OrderedNode *update[MAX_LEVEL];
+    findBefore(index, entry->score, entry->seq, update);
+    if (update[0]->next[0] != entry) {
+        return failure; // The entry is not in this index
+    }
+    for (int i = 0; i < entry->level; i++) {
+        update[i]->next[i] = entry->next[i]; // Unlink the node from each of its levels
+    }
+    while (index->level > 1 && index->head->next[index->level - 1] == NULL) {
+        index->level--; // Drop levels left empty
+    }
+    releaseBlock(index->allocator, entry, nodeSize(entry->level));
+    index->size--;
+    return success;
+}
+
+// Function to find the first entry with a score greater than or equal to a score
+orderedEntry ceilingInOrderedIndex(orderedIndex index, double score) {
+    if (!index) {
+        return NULL; // Ensure the index is valid
+    }
+    return findBefore(index, score, 0, NULL)->next[0];
+}
+
+// Function to find the first entry with a score strictly greater than a score
+orderedEntry higherInOrderedIndex(orderedIndex index, double score) {
+    if (!index) {
+        return NULL; // Ensure the index is valid
+    }
+    OrderedNode *node = index->head;
+    for (int i = index->level - 1; i >= 0; i--) {
+        while (node->next[i] && node->next[i]->score <= score) {
+            node = node->next[i];
+        }
+    }
+    return node->next[0];
+}
+
+// Function to find the first inserted entry holding the greatest score lower than or equal to a score
+orderedEntry floorInOrderedIndex(orderedIndex index, double score) {
+    if (!index) {
+        return NULL; // Ensure the index is valid
+    }
+    OrderedNode *node = index->head;
+    for (int i = index->level - 1; i >= 0; i--) {
+        while (node->next[i] && node->next[i]->score <= score) {
+            node = node->next[i];
+        }
+    }
+    if (node == index->head) {
+        return NULL; // Every score is greater
+    }
+    return ceilingInOrderedIndex(index, node->score); // The last entry of its run: go back to the first
+}
+
+// Function to get the entry with the lowest score
+orderedEntry orderedBegin(orderedIndex index) {
+    if (!index) {
+        return NULL; // Ensure the index is valid
+    }
+    return index->head->next[0];
+}
+
+// Function to get the entry with the highest score
+orderedEntry orderedLast(orderedIndex index) {
+    if (!index) {
+        return NULL; // Ensure the index is valid
+    }
+    OrderedNode *node = index->head;
+    for (int i = index->level - 1; i >= 0; i--) {
+        while (node->next[i]) {
+            node = node->next[i];
+        }
+    }
+    return node == index->head ? NULL : node;
+}
+
+// Function to advance to the next entry
+orderedEntry orderedNext(orderedEntry entry) {
+    if (!entry) {
+        return NULL;
+    }
+    return entry->next[0];
+}
+
+// Function to get the score of an entry
+double getOrderedScore(orderedEntry entry) {
+    if (!entry) {
+        return 0;
+    }
+    return entry->score;
+}
+
+// Function to get the element stored in an entry
+Element getOrderedData(orderedEntry entry) {
+    if (!entry) {
+        return NULL;
+    }
+    return entry->data;
+}
+
+// Function to check whether an entry was inserted before another one
+bool orderedInsertedBefore(orderedEntry a, orderedEntry b) {
+    if (!a || !b) {
+        return false;
+    }
+    return a->seq < b->seq;
+}
+
+// Function to get the number of entries in the index
+int getOrderedIndexSize(orderedIndex index) {
+    if (!index) {
+        return 0;
+    }
+    return index->size;
+}
@@ -0,0 +1,127 @@
+
+#ifndef ORDEREDINDEX_H
+#define ORDEREDINDEX_H
+#include "Defs.h"
+#include "Allocator.h"
+
+/**
+ * @file OrderedIndex.h
+ * @brief Interface for an index of elements kept sorted by a numeric score.
+ *
+ * The index is a skip list: insertion, removal and the floor/ceiling
+ * searches take O(log n) expected time, and walking forward from a
+ * search result costs O(1) per element. Entries with equal scores are
+ * kept in insertion order, so the first entry of a run of equal scores
+ * is always the one inserted first.
+ * The index never copies or frees the elements it holds.
+ */
+
+/** A type for an ordered index handle. */
+typedef struct orderedIndex_s *orderedIndex;
+
+/** A type for an entry of an ordered index, used for iteration and as a removal handle. */
+typedef struct orderedNode_s *orderedEntry;
+
+/**
+ * @brief Creates a new, empty ordered index.
+ * @return A handle to the new index, or NULL if the allocation failed.
+ */
+orderedIndex createOrderedIndex(void);
+
+/**
+ * @brief Destroys an ordered index and all of its entries.
+ * The elements themselves are not freed.
+ * @param index The index to destroy.
+ * @return Status of the operation (success or failure).
+ */
+status destroyOrderedIndex(orderedIndex index);
+
+/**
+ * @brief Makes an index allocate its entries from an allocator instead of malloc.
+ * Must be called while the index is empty.
+ * @param index The ordered index.
+ * @param allocator The allocator, which must outlive the index, or NULL for malloc.
+ * @return Status of the operation (success or failure).
+ */
+status setOrderedIndexAllocator(orderedIndex index, const Allocator *allocator);
+
+/**
+ * @brief Inserts an element with a score.
+ * The entry is placed after every entry with the same score.
+ * @param index The ordered index.
+ * @param score The score the element is ordered by.
+ * @param data The element to store. It is not copied.
+ * @return A handle to the new entry, valid until it is removed, or NULL if the operation failed.
+ */
+orderedEntry insertInOrderedIndex(orderedIndex index, double score, Element data);
+
+/**
+ * @brief Removes an entry using the handle returned by insertInOrderedIndex.
+ * @param index The index the entry belongs to.
+ * @param entry The entry to remove.
+ * @return Status of the operation (success or failure).
+ */
+status removeFromOrderedIndex(orderedIndex index, orderedEntry entry);
+
+/**
+ * @brief Finds the first entry whose score is greater than or equal to a score.
+ * @return The entry, or NULL if every score is lower.
+ */
+orderedEntry ceilingInOrderedIndex(orderedIndex index, double score);
+
+/**
+ * @brief Finds the first entry whose score is strictly greater than a score.
+ * @return The entry, or NULL if no score is greater.
+ */
+orderedEntry higherInOrderedIndex(orderedIndex index, double score);
+
+/**
+ * @brief Finds the greatest score lower than or equal to a score, and returns
+ * the first inserted entry holding it.
+ * @return The entry, or NULL if every score is greater.
+ */
+orderedEntry floorInOrderedIndex(orderedIndex index, double score);
+
+/**
+ * @brief Gets the entry with the lowest score (the first inserted on ties).
+ * @return The entry, or NULL if the index is empty.
+ */
+orderedEntry orderedBegin(orderedIndex index);
+
+/**
+ * @brief Gets the entry with the highest score (the last inserted on ties), in O(log n) expected time.
+ * @return The entry, or NULL if the index is empty.
+ */
+orderedEntry orderedLast(orderedIndex index);
+
+/**
+ * @brief Advances to the next entry in score order.
+ * @return The following entry, or NULL if entry was the last one.
+ */
+orderedEntry orderedNext(orderedEntry entry);
+
+/**
+ * @brief Gets the score of an entry.
+ * @return The score, or 0 if the entry is NULL.
+ */
+double getOrderedScore(orderedEntry entry);
+
+/**
+ * @brief Gets the element stored in an entry (not a copy).
+ * @return The element, or NULL if the entry is NULL.
+ */
+Element getOrderedData(orderedEntry entry);
+
+/**
+ * @brief Checks whether an entry was inserted before another one.
+ * @return true if a was inserted into its index before b, false otherwise.
+ */
+bool orderedInsertedBefore(orderedEntry a, orderedEntry b);
+
+/**
+ * @brief Gets the number of entries in the index.
+ * @return The number of entries, or 0 if the index is NULL.
+ */
+int getOrderedIndexSize(orderedIndex index);
+
+#endif //ORDEREDINDEX_H
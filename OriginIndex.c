@@ -0,0 +1,319 @@
+#include <stdint.h>
+#include "OriginIndex.h"
+#include "MultiValueHashTable.h"
+#include "HashTable.h"
+#include "HappinessIndex.h"
+#include "SimdKernels.h"
+
+// Happiness of the Jerries of one planet or reality
+typedef struct {
+    int levels[HAPPINESS_LEVELS]; // Number of Jerries at each level
+    int *outside; // Levels outside 0..100, one per Jerry, until the next activity clamps them
+    int outside_count;
+    int outside_capacity;
+    runningAggregate stats; // Aggregate of the levels of every Jerry of the group
+} HappinessGroup;
+
+// Origin index structure: the Jerries of each planet and of each reality, and their happiness
+typedef struct origin_index_s {
+    multiValueHashTable by_planet; // Planet -> Jerries from it
+    multiValueHashTable by_reality; // Interned reality -> Jerries from it
+    hashTable planet_groups; // Planet -> happiness of its Jerries
+    hashTable reality_groups; // Interned reality -> happiness of its Jerries
+    HappinessGroup **groups; // Every group, for the activities to visit (owned)
+    int group_count;
+    int group_capacity;
+} OriginIndex;
+
+static status print_key(Element key) {
+    printf("%s : \n", (char *)key);
+    return success;
+}
+
+static status print_planet_key(Element planet) {
+    printf("%s : \n", ((Planet *)planet)->name);
+    return success;
+}
+
+// Hash a planet by its address, not its name: two planets may share a name
+static int hash_planet(Element planet) {
+    return (int)((uintptr_t)planet >> 4); // Allocations are aligned, the low bits carry nothing
+}
+
+static status print_origin_jerry(Element jerry) {
+    return print_jerry((Jerry *)jerry);
+}
+
+static status print_group(Element group) {
+    printf("%ld Jerries", ((HappinessGroup *)group)->stats.count);
+    return success;
+}
+
+// Create one table of happiness groups by a pointer key, hashed by transformIntoNumber or as a string if NULL.
+// The groups are owned by the index's array: the table copies and frees neither keys nor groups
+static hashTable create_group_table(PrintFunction print, TransformIntoNumberFunction transformIntoNumber, int size) {
+    return createOpenHashTable(borrowElement, keepElement, print, borrowElement, keepElement, print_group, sameElement,
+                               transformIntoNumber, size);
+}
+
+// Get the group of a key, creating it on first use
+static HappinessGroup *group_of(OriginIndex *index, hashTable table, Element key) {
+    HappinessGroup *group = borrowFromHashTable(table, key);
+    if (group) {
+        return group;
+    }
+    if (index->group_count == index->group_capacity) {
+        int capacity = index->group_capacity ? index->group_capacity * 2 : 16;
+        HappinessGroup **groups = realloc(index->groups, capacity * sizeof(HappinessGroup *));
+        if (!groups) {
+            return NULL;
+        }
+        index->groups = groups;
+        index->group_capacity = capacity;
+    }
+    group = calloc(1, sizeof(HappinessGroup)); // Empty histogram, no outside levels, empty aggregate
+    if (!group) {
+        return NULL;
+    }
+    if (addToHashTable(table, key, group) == failure) {
+        free(group);
+        return NULL;
+    }
+    index->groups[index->group_count++] = group;
+    return group;
+}
+
+// Count a level in a group
+static status add_level(HappinessGroup *group, int level) {
+    if (level < 0 || level >= HAPPINESS_LEVELS) {
+        if (group->outside_count == group->outside_capacity) {
+            int capacity = group->outside_capacity ? group->outside_capacity * 2 : 4;
+            int *outside = realloc(group->outside, capacity * sizeof(int));
+            if (!outside) {
+                return failure;
+            }
+            group->outside = outside;
+            group->outside_capacity = capacity;
+        }
+        group->outside[group->outside_count++] = level;
+    } else {
+        group->levels[level]++;
+    }
+    addToAggregate(&group->stats, level);
+    return success;
+}
+
+// Stop counting a level in a group
+static void remove_level(HappinessGroup *group, int level) {
+    if (level < 0 || level >= HAPPINESS_LEVELS) {
+        for (int i = 0; i < group->outside_count; i++) {
+            if (group->outside[i] == level) {
+                group->outside[i] = group->outside[--group->outside_count]; // Order does not matter
+                break;
+            }
+        }
+    } else if (group->levels[level] > 0) {
+        group->levels[level]--;
+    }
+    removeFromAggregate(&group->stats, level);
+}
+
+// Recompute the bounds of a group from its histogram and outside levels
+static void refresh_bounds(HappinessGroup *group) {
+    int min = HAPPINESS_LEVELS, max = -1;
+    for (int level = 0; level < HAPPINESS_LEVELS; level++) {
+        if (group->levels[level] > 0) {
+            min = level < min ? level : min;
+            max = level;
+        }
+    }
+    for (int i = 0; i < group->outside_count; i++) {
+        min = group->outside[i] < min ? group->outside[i] : min;
+        max = group->outside[i] > max ? group->outside[i] : max;
+    }
+    setAggregateBounds(&group->stats, min, max);
+}
+
+// Move the bins of a group through an activity, given as the level each level maps to
+static void apply_to_group(HappinessGroup *group, const int *mapped, int above, int addabove, int decbelow) {
+    if (group->stats.count == 0) {
+        return;
+    }
+    int levels[HAPPINESS_LEVELS] = {0};
+    for (int level = 0; level < HAPPINESS_LEVELS; level++) {
+        levels[mapped[level]] += group->levels[level];
+    }
+    // Levels outside 0..100 are mapped one by one, and land inside
+    thresholdAddClamp(group->outside, group->outside_count, above, addabove, decbelow, 0, HAPPINESS_LEVELS - 1);
+    for (int i = 0; i < group->outside_count; i++) {
+        levels[group->outside[i]]++;
+    }
+    group->outside_count = 0;
+    resetAggregate(&group->stats);
+    for (int level = 0; level < HAPPINESS_LEVELS; level++) {
+        group->levels[level] = levels[level];
+        group->stats.count += levels[level];
+        group->stats.sum += (double)level * levels[level];
+        group->stats.sumSquares += (double)level * level * levels[level];
+    }
+    refresh_bounds(group);
+}
+
+// Create one table of Jerries by a pointer key, hashed by transformIntoNumber or as a string if NULL.
+// The keys are planets or interned realities, equal exactly when their pointers are, and the lists only
+// refer to the Jerries: the table copies and frees nothing
+static multiValueHashTable create_origin_table(PrintFunction print, TransformIntoNumberFunction transformIntoNumber,
+                                               int size, const Allocator *allocator) {
+    multiValueHashTable table = createMultiValueHashTable(borrowElement, keepElement, print, borrowElement, keepElement,
+                                                          print_origin_jerry, sameElement, transformIntoNumber, size,
+                                                          sameElement);
+    if (table && allocator) {
+        setMultiValueAllocator(table, allocator);
+    }
+    return table;
+}
+
+// Create an empty origin index
+origin_index create_origin_index(int size, const Allocator *allocator) {
+    OriginIndex *index = malloc(sizeof(OriginIndex));
+    if (!index) {
+        return NULL;
+    }
+    index->groups = NULL;
+    index->group_count = 0;
+    index->group_capacity = 0;
+    index->by_planet = create_origin_table(print_planet_key, hash_planet, size > 0 ? size : 1, allocator);
+    index->by_reality = create_origin_table(print_key, NULL, size > 0 ? size : 1, allocator);
+    index->planet_groups = create_group_table(print_planet_key, hash_planet, size > 0 ? size : 1);
+    index->reality_groups = create_group_table(print_key, NULL, size > 0 ? size : 1);
+    if (!index->by_planet || !index->by_reality || !index->planet_groups || !index->reality_groups) {
+        destroy_origin_index(index);
+        return NULL;
+    }
+    return index;
+}
+
+// Free an origin index and its tables
+void destroy_origin_index(origin_index index) {
+    if (!index) {
+        return;
+    }
+    if (index->by_planet) {
+        destroyMultiValueHashTable(index->by_planet);
+    }
+    if (index->by_reality) {
+        destroyMultiValueHashTable(index->by_reality);
+    }
+    destroyHashTable(index->planet_groups);
+    destroyHashTable(index->reality_groups);
+    for (int i = 0; i < index->group_count; i++) {
+        free(index->groups[i]->outside);
+        free(index->groups[i]);
+    }
+    free(index->groups);
+    free(index);
+}
+
+// Add a Jerry under its planet and its reality
+status add_to_origin_index(origin_index index, Jerry *jerry) {
+    if (!index || !jerry || !jerry->origin) {
+        return failure;
+    }
+    Origin *origin = jerry->origin;
+    HappinessGroup *planet_group = group_of(index, index->planet_groups, (Element)origin->planet);
+    HappinessGroup *reality_group = group_of(index, index->reality_groups, (Element)origin->reality);
+    if (!planet_group || !reality_group) {
+        return failure; // An empty group is harmless
+    }
+    if (add_level(planet_group, jerry->happiness) == failure) {
+        return failure;
+    }
+    if (add_level(reality_group, jerry->happiness) == failure) {
+        remove_level(planet_group, jerry->happiness);
+        return failure;
+    }
+    jerry->planet_entry = addToMultiValueHashTableWithHandle(index->by_planet, (Element)origin->planet, jerry);
+    jerry->reality_entry = jerry->planet_entry ?
+        addToMultiValueHashTableWithHandle(index->by_reality, (Element)origin->reality, jerry) : NULL;
+    if (!jerry->reality_entry) {
+        if (jerry->planet_entry) {
+            removeFromMultiValueHashTableByHandle(index->by_planet, (Element)origin->planet, jerry->planet_entry);
+            jerry->planet_entry = NULL;
+        }
+        remove_level(planet_group, jerry->happiness);
+        remove_level(reality_group, jerry->happiness);
+        return failure;
+    }
+    return success;
+}
+
+// Remove a Jerry through the handles of its entries
+status remove_from_origin_index(origin_index index, Jerry *jerry) {
+    if (!index || !jerry || !jerry->planet_entry || !jerry->reality_entry) {
+        return failure;
+    }
+    Origin *origin = jerry->origin;
+    removeFromMultiValueHashTableByHandle(index->by_planet, (Element)origin->planet, jerry->planet_entry);
+    removeFromMultiValueHashTableByHandle(index->by_reality, (Element)origin->reality, jerry->reality_entry);
+    remove_level(borrowFromHashTable(index->planet_groups, (Element)origin->planet), jerry->happiness);
+    remove_level(borrowFromHashTable(index->reality_groups, (Element)origin->reality), jerry->happiness);
+    jerry->planet_entry = NULL;
+    jerry->reality_entry = NULL;
+    return success;
+}
+
+// Apply an activity to the happiness of every group
+void apply_activity_to_origin_index(origin_index index, int above, int addabove, int decbelow) {
+    if (!index) {
+        return;
+    }
+    int mapped[HAPPINESS_LEVELS]; // The level each level maps to, shared by every group
+    for (int level = 0; level < HAPPINESS_LEVELS; level++) {
+        mapped[level] = level;
+    }
+    thresholdAddClamp(mapped, HAPPINESS_LEVELS, above, addabove, decbelow, 0, HAPPINESS_LEVELS - 1);
+    for (int i = 0; i < index->group_count; i++) {
+        apply_to_group(index->groups[i], mapped, above, addabove, decbelow);
+    }
+}
+
+// Get the happiness aggregate of the group of a key
+static status group_stats(hashTable table, Element key, runningAggregate *stats) {
+    HappinessGroup *group = key ? borrowFromHashTable(table, key) : NULL;
+    if (!group || !stats || group->stats.count == 0) {
+        return failure;
+    }
+    if (group->stats.boundsStale) {
+        refresh_bounds(group); // 101 steps, plus the rare levels outside 0..100
+    }
+    *stats = group->stats;
+    return success;
+}
+
+// Get the happiness aggregate of the Jerries from a planet
+status planet_happiness_stats(origin_index index, Planet *planet, runningAggregate *stats) {
+    return index ? group_stats(index->planet_groups, (Element)planet, stats) : failure;
+}
+
+// Get the happiness aggregate of the Jerries from a reality
+status reality_happiness_stats(origin_index index, const char *reality, runningAggregate *stats) {
+    const char *key = findInternedCopy(reality); // A reality never interned is no Jerry's reality
+    return index ? group_stats(index->reality_groups, (Element)key, stats) : failure;
+}
+
+// Get the Jerries from a planet
+linkedlist jerries_from_planet(origin_index index, Planet *planet) {
+    if (!index || !planet) {
+        return NULL;
+    }
+    return lookupInMultiValueHashTable(index->by_planet, (Element)planet);
+}
+
+// Get the Jerries from a reality
+linkedlist jerries_from_reality(origin_index index, const char *reality) {
+    const char *key = findInternedCopy(reality);
+    if (!index || !key) {
+        return NULL;
+    }
+    return lookupInMultiValueHashTable(index->by_reality, (Element)key);
+}
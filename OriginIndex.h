@@ -0,0 +1,110 @@
+#ifndef ORIGININDEX_H
+#define ORIGININDEX_H
+#include "Defs.h"
+#include "Jerry.h"
+#include "LinkedList.h"
+#include "Allocator.h"
+#include "Aggregate.h"
+
+/**
+ * @file OriginIndex.h
+ * @brief Reverse indexes of Jerries by origin planet and by reality.
+ *
+ * Two multi-value hash tables, keyed by the origin planet (the Planet
+ * itself, as two planets may share a name) and the interned reality of
+ * each Jerry, list the Jerries of every key in insertion order. A query takes one hash probe and returns the list
+ * itself, so listing or counting the Jerries of a planet or a reality costs
+ * time proportional to the result, not to the number of Jerries. Each Jerry
+ * keeps the handles of its two entries in its `planet_entry` and
+ * `reality_entry` fields, so removing it takes constant time.
+ *
+ * Every planet and reality also keeps the aggregate of its Jerries'
+ * happiness, as a histogram of the levels 0..100 (plus the rare levels
+ * outside them, which only a Jerry added with such a happiness has until
+ * the next activity). An activity maps every level through the same
+ * function, so it moves whole bins: 101 steps per planet or reality,
+ * whatever the number of Jerries. The index reads the happiness field of a
+ * Jerry when it is added or removed, so the field must be up to date then
+ * (see sync_happiness).
+ */
+
+/** A type for an origin index handle. */
+typedef struct origin_index_s *origin_index;
+
+/**
+ * Creates a new, empty origin index.
+ * @param size The expected number of planets (and realities).
+ * @param allocator The allocator the tables draw their pairs, lists and nodes from, or NULL for malloc.
+ * @return A handle to the new index, or NULL if memory allocation fails.
+ */
+origin_index create_origin_index(int size, const Allocator *allocator);
+
+/**
+ * Frees an origin index. The Jerries themselves are not freed.
+ * @param index The index to free.
+ */
+void destroy_origin_index(origin_index index);
+
+/**
+ * Adds a Jerry under its origin planet and its reality, after every Jerry already there.
+ * @param index The origin index.
+ * @param jerry The Jerry to add. Its `planet_entry` and `reality_entry` fields are set.
+ * @return `success` if the Jerry was added to both tables, otherwise `failure` (and it is in neither).
+ */
+status add_to_origin_index(origin_index index, Jerry *jerry);
+
+/**
+ * Removes a Jerry from the index in constant time.
+ * @param index The origin index.
+ * @param jerry The Jerry to remove.
+ * @return `success` if the Jerry was removed, otherwise `failure`.
+ */
+status remove_from_origin_index(origin_index index, Jerry *jerry);
+
+/**
+ * Applies an activity to the happiness aggregates: levels at or above the threshold
+ * gain addabove, the others lose decbelow, clamped to 0..100, as apply_happiness_activity does.
+ * @param index The origin index.
+ * @param above The threshold.
+ * @param addabove Amount added to levels at or above the threshold.
+ * @param decbelow Amount removed from levels below the threshold.
+ */
+void apply_activity_to_origin_index(origin_index index, int above, int addabove, int decbelow);
+
+/**
+ * Gets the aggregate of the happiness of the Jerries from a planet, in constant time.
+ * @param index The origin index.
+ * @param planet The planet.
+ * @param stats Receives the aggregate.
+ * @return `success`, or `failure` if no Jerry comes from the planet.
+ */
+status planet_happiness_stats(origin_index index, Planet *planet, runningAggregate *stats);
+
+/**
+ * Gets the aggregate of the happiness of the Jerries from a reality, in constant time.
+ * @param index The origin index.
+ * @param reality The reality.
+ * @param stats Receives the aggregate.
+ * @return `success`, or `failure` if no Jerry comes from the reality.
+ */
+status reality_happiness_stats(origin_index index, const char *reality, runningAggregate *stats);
+
+/**
+ * Gets the Jerries from a planet.
+ * @param index The origin index.
+ * @param planet The planet.
+ * @return The Jerries in insertion order (the list itself, which must not be changed or freed),
+ *         or NULL if no Jerry comes from the planet.
+ */
+linkedlist jerries_from_planet(origin_index index, Planet *planet);
+
+/**
+ * Gets the Jerries from a reality.
+ * @param index The origin index.
+ * @param reality The reality.
+ * @return The Jerries in insertion order (the list itself, which must not be changed or freed),
+ *         or NULL if no Jerry comes from the reality.
+ */
+linkedlist jerries_from_reality(origin_index index, const char *reality);
+
+#endif //ORIGININDEX_H
@@ -0,0 +1,274 @@
+#include "PlanetTree.h"
+
+// A planet of the tree, with its position in the array the tree was built from
+typedef struct {
+    Planet *planet;
+    int order; // Breaks distance ties
+} TreeNode;
+
+// A planet found by a query, with its squared distance to the point
+typedef struct {
+    double distance;
+    int order;
+    Planet *planet;
+} Found;
+
+// Planet tree structure: the nodes in implicit k-d order
+typedef struct planet_tree_s {
+    TreeNode *nodes; // The node of a range [low, high) is nodes[(low + high) / 2]
+    int count; // Number of planets
+} PlanetTree;
+
+// Get the coordinate of a planet along an axis (0 for x, 1 for y, 2 for z)
+static double axis_value(const Planet *planet, int axis) {
+    return axis == 0 ? planet->coord.x : axis == 1 ? planet->coord.y : planet->coord.z;
+}
+
+// Get the coordinate of a point along an axis
+static double point_value(coord point, int axis) {
+    return axis == 0 ? point.x : axis == 1 ? point.y : point.z;
+}
+
+// Squared distance between a planet and a point
+static double squared_distance(const Planet *planet, coord point) {
+    double dx = planet->coord.x - point.x, dy = planet->coord.y - point.y, dz = planet->coord.z - point.z;
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Order two nodes along an axis, ties by position so the order is total
+static bool node_before(const TreeNode *node1, const TreeNode *node2, int axis) {
+    double value1 = axis_value(node1->planet, axis), value2 = axis_value(node2->planet, axis);
+    return value1 < value2 || (value1 == value2 && node1->order < node2->order);
+}
+
+// Whether a found planet is farther from the point than another, ties by position
+static bool farther(const Found *found1, const Found *found2) {
+    return found1->distance > found2->distance ||
+           (found1->distance == found2->distance && found1->order > found2->order);
+}
+
+static void swap_nodes(TreeNode *node1, TreeNode *node2) {
+    TreeNode temp = *node1;
+    *node1 = *node2;
+    *node2 = temp;
+}
+
+// Put the node of rank nth of [low, high) along an axis at nth, smaller ones before it and larger ones after it
+static void select_node(TreeNode *nodes, int low, int high, int nth, int axis) {
+    while (high - low > 1) {
+        swap_nodes(&nodes[(low + high) / 2], &nodes[high - 1]); // Middle pivot, fine on sorted input
+        TreeNode *pivot = &nodes[high - 1];
+        int store = low;
+        for (int i = low; i < high - 1; i++) {
+            if (node_before(&nodes[i], pivot, axis)) {
+                swap_nodes(&nodes[i], &nodes[store++]);
+            }
+        }
+        swap_nodes(&nodes[store], pivot);
+        if (store == nth) {
+            return;
+        }
+        if (nth < store) {
+            high = store;
+        } else {
+            low = store + 1;
+        }
+    }
+}
+
+// Arrange [low, high) into a subtree split along the axis of its depth
+static void build(TreeNode *nodes, int low, int high, int depth) {
+    if (high - low <= 1) {
+        return;
+    }
+    int middle = (low + high) / 2;
+    select_node(nodes, low, high, middle, depth % 3);
+    build(nodes, low, middle, depth + 1);
+    build(nodes, middle + 1, high, depth + 1);
+}
+
+// Create a planet tree over an array of planets
+planet_tree create_planet_tree(Planet **planets, int count) {
+    if (count < 0 || (count > 0 && !planets)) {
+        return NULL;
+    }
+    PlanetTree *tree = malloc(sizeof(PlanetTree));
+    if (!tree) {
+        return NULL;
+    }
+    tree->nodes = malloc((count > 0 ? count : 1) * sizeof(TreeNode));
+    if (!tree->nodes) {
+        free(tree);
+        return NULL;
+    }
+    tree->count = count;
+    for (int i = 0; i < count; i++) {
+        tree->nodes[i].planet = planets[i];
+        tree->nodes[i].order = i;
+    }
+    build(tree->nodes, 0, count, 0);
+    return tree;
+}
+
+// Free a planet tree
+void destroy_planet_tree(planet_tree tree) {
+    if (!tree) {
+        return;
+    }
+    free(tree->nodes);
+    free(tree);
+}
+
+// Get the number of planets in a tree
+int planet_tree_size(planet_tree tree) {
+    return tree ? tree->count : 0;
+}
+
+// Restore the max-heap (farthest planet on top) below a position
+static void sift_down(Found *heap, int size, int position) {
+    while (true) {
+        int largest = position, left = 2 * position + 1, right = left + 1;
+        if (left < size && farther(&heap[left], &heap[largest])) {
+            largest = left;
+        }
+        if (right < size && farther(&heap[right], &heap[largest])) {
+            largest = right;
+        }
+        if (largest == position) {
+            return;
+        }
+        Found temp = heap[position];
+        heap[position] = heap[largest];
+        heap[largest] = temp;
+        position = largest;
+    }
+}
+
+// Restore the max-heap above a position
+static void sift_up(Found *heap, int position) {
+    while (position > 0 && farther(&heap[position], &heap[(position - 1) / 2])) {
+        Found temp = heap[position];
+        heap[position] = heap[(position - 1) / 2];
+        heap[(position - 1) / 2] = temp;
+        position = (position - 1) / 2;
+    }
+}
+
+// State of a k nearest query: the k closest planets so far, farthest on top
+typedef struct {
+    coord point;
+    Found *heap;
+    int size;
+    int k;
+} NearestQuery;
+
+// Offer the planets of the subtree [low, high) to a k nearest query
+static void search_nearest(const TreeNode *nodes, int low, int high, int depth, NearestQuery *query) {
+    if (low >= high) {
+        return;
+    }
+    int middle = (low + high) / 2;
+    const TreeNode *node = &nodes[middle];
+    Found candidate = {squared_distance(node->planet, query->point), node->order, node->planet};
+    if (query->size < query->k) {
+        query->heap[query->size] = candidate;
+        sift_up(query->heap, query->size++);
+    } else if (farther(&query->heap[0], &candidate)) {
+        query->heap[0] = candidate;
+        sift_down(query->heap, query->size, 0);
+    }
+    int axis = depth % 3;
+    double offset = point_value(query->point, axis) - axis_value(node->planet, axis);
+    bool near_low = offset < 0; // The side of the split the point lies on is searched first
+    search_nearest(nodes, near_low ? low : middle + 1, near_low ? middle : high, depth + 1, query);
+    // The other side only holds planets at least |offset| away along the axis
+    if (query->size < query->k || offset * offset <= query->heap[0].distance) {
+        search_nearest(nodes, near_low ? middle + 1 : low, near_low ? high : middle, depth + 1, query);
+    }
+}
+
+// qsort order of found planets: closest first, ties by position
+static int compare_found(const void *found1, const void *found2) {
+    if (farther(found1, found2)) {
+        return 1;
+    }
+    return farther(found2, found1) ? -1 : 0;
+}
+
+// Find the k planets closest to a point
+int nearest_planets(planet_tree tree, coord point, int k, Planet **found) {
+    if (!tree || !found || k <= 0) {
+        return 0;
+    }
+    if (k > tree->count) {
+        k = tree->count;
+    }
+    if (k == 0) {
+        return 0;
+    }
+    NearestQuery query = {point, malloc(k * sizeof(Found)), 0, k};
+    if (!query.heap) {
+        return -1;
+    }
+    search_nearest(tree->nodes, 0, tree->count, 0, &query);
+    qsort(query.heap, query.size, sizeof(Found), compare_found);
+    for (int i = 0; i < query.size; i++) {
+        found[i] = query.heap[i].planet;
+    }
+    free(query.heap);
+    return query.size;
+}
+
+// Find the planet closest to a point
+Planet *nearest_planet(planet_tree tree, coord point) {
+    Planet *found = NULL;
+    return nearest_planets(tree, point, 1, &found) == 1 ? found : NULL;
+}
+
+// State of a radius query: the planets found so far
+typedef struct {
+    coord point;
+    double radius; // Squared
+    Found *found;
+    int size;
+} RadiusQuery;
+
+// Collect the planets of the subtree [low, high) within the radius
+static void search_within(const TreeNode *nodes, int low, int high, int depth, RadiusQuery *query) {
+    if (low >= high) {
+        return;
+    }
+    int middle = (low + high) / 2;
+    const TreeNode *node = &nodes[middle];
+    double distance = squared_distance(node->planet, query->point);
+    if (distance <= query->radius) {
+        Found hit = {distance, node->order, node->planet};
+        query->found[query->size++] = hit;
+    }
+    int axis = depth % 3;
+    double offset = point_value(query->point, axis) - axis_value(node->planet, axis);
+    if (offset <= 0 || offset * offset <= query->radius) { // The low side can reach the point
+        search_within(nodes, low, middle, depth + 1, query);
+    }
+    if (offset >= 0 || offset * offset <= query->radius) { // The high side can reach the point
+        search_within(nodes, middle + 1, high, depth + 1, query);
+    }
+}
+
+// Find every planet within a distance of a point
+int planets_within(planet_tree tree, coord point, float radius, Planet **found) {
+    if (!tree || !found || radius < 0 || tree->count == 0) {
+        return 0;
+    }
+    RadiusQuery query = {point, (double)radius * radius, malloc(tree->count * sizeof(Found)), 0};
+    if (!query.found) {
+        return -1;
+    }
+    search_within(tree->nodes, 0, tree->count, 0, &query);
+    qsort(query.found, query.size, sizeof(Found), compare_found);
+    for (int i = 0; i < query.size; i++) {
+        found[i] = query.found[i].planet;
+    }
+    free(query.found);
+    return query.size;
+}
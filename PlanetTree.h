@@ -0,0 +1,74 @@
+#ifndef PLANETTREE_H
+#define PLANETTREE_H
+#include "Defs.h"
+#include "Jerry.h"
+
+/**
+ * @file PlanetTree.h
+ * @brief A k-d tree over the coordinates of the planets, for nearest and radius queries.
+ *
+ * The tree is built once over a fixed set of planets and stored implicitly
+ * in one array: the node of a range is its median along the axis of its
+ * depth (x, y, z in turn), with the halves of the range as its subtrees.
+ * A query visits only the subtrees that can hold a close enough planet, so
+ * it costs O(log n) for the nearest planet on a well spread set instead of
+ * a scan over every planet.
+ *
+ * Results are ordered by distance; planets at the same distance keep the
+ * order they had in the array the tree was built from. The tree refers to
+ * the planets without owning them, so they must outlive it.
+ */
+
+/** A type for a planet tree handle. */
+typedef struct planet_tree_s *planet_tree;
+
+/**
+ * Builds a tree over planets, in O(n log n).
+ * @param planets The planets. The array is copied, the planets are not.
+ * @param count The number of planets.
+ * @return A handle to the new tree, or NULL if memory allocation fails.
+ */
+planet_tree create_planet_tree(Planet **planets, int count);
+
+/**
+ * Frees a planet tree. The planets themselves are not freed.
+ * @param tree The tree to free.
+ */
+void destroy_planet_tree(planet_tree tree);
+
+/**
+ * Gets the number of planets in a tree.
+ * @param tree The planet tree.
+ * @return The number of planets, or 0 if the tree is NULL.
+ */
+int planet_tree_size(planet_tree tree);
+
+/**
+ * Finds the planet closest to a point.
+ * @param tree The planet tree.
+ * @param point The point.
+ * @return The closest planet, or NULL if the tree is empty.
+ */
+Planet *nearest_planet(planet_tree tree, coord point);
+
+/**
+ * Finds the k planets closest to a point, closest first.
+ * @param tree The planet tree.
+ * @param point The point.
+ * @param k The number of planets wanted.
+ * @param found Receives the planets; must have room for k of them.
+ * @return The number of planets found (k, or fewer if the tree is smaller), or -1 if memory allocation fails.
+ */
+int nearest_planets(planet_tree tree, coord point, int k, Planet **found);
+
+/**
+ * Finds every planet within a distance of a point (the distance included), closest first.
+ * @param tree The planet tree.
+ * @param point The point.
+ * @param radius The distance.
+ * @param found Receives the planets; must have room for planet_tree_size(tree) of them.
+ * @return The number of planets found, or -1 if memory allocation fails.
+ */
+int planets_within(planet_tree tree, coord point, float radius, Planet **found);
+
+#endif //PLANETTREE_H
@@ -0,0 +1,127 @@
+#include "Pool.h"
+
+// Blocks are aligned to, and sized in multiples of, this many bytes
+#define ALIGNMENT 16
+// Default number of blocks per slab
+#define DEFAULT_BLOCKS 256
+
+// Header at the start of every slab
+typedef struct slab_s {
+    struct slab_s *next; // Slab allocated before this one
+} Slab;
+
+// A released block, linked into the free list
+typedef struct freeBlock_s {
+    struct freeBlock_s *next; // Next released block
+} FreeBlock;
+
+// Pool structure: the slabs, the unused tail of the newest one, and the released blocks
+typedef struct pool_s {
+    Slab *slabs; // Newest slab first
+    char *cursor; // Next never used block of the newest slab
+    char *limit; // End of the newest slab
+    FreeBlock *released; // Released blocks, most recent first
+    size_t blockSize; // Size of every block, rounded to the alignment
+    int blocksPerSlab; // Number of blocks of each slab
+    int slabCount; // Number of slabs allocated
+} Pool;
+
+// Round a size up to the alignment
+static size_t roundUp(size_t size) {
+    return (size + ALIGNMENT - 1) & ~(size_t)(ALIGNMENT - 1);
+}
+
+// Function to create a pool
+pool createPool(size_t blockSize, int blocksPerSlab) {
+    if (blockSize == 0 || blocksPerSlab < 0) {
+        return NULL;
+    }
+    Pool *pool = malloc(sizeof(Pool));
+    if (!pool) {
+        return NULL;
+    }
+    pool->slabs = NULL;
+    pool->cursor = NULL;
+    pool->limit = NULL;
+    pool->released = NULL;
+    pool->blockSize = roundUp(blockSize);
+    pool->blocksPerSlab = blocksPerSlab ? blocksPerSlab : DEFAULT_BLOCKS;
+    pool->slabCount = 0;
+    return pool;
+}
+
+// Function to destroy a pool
+void destroyPool(pool pool) {
+    if (!pool) {
+        return;
+    }
+    Slab *slab = pool->slabs;
+    while (slab) {
+        Slab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(pool);
+}
+
+// Function to allocate a block
+void *poolAllocate(pool pool) {
+    if (!pool) {
+        return NULL;
+    }
+    if (pool->released) {
+        FreeBlock *block = pool->released; // Reuse the most recently released block
+        pool->released = block->next;
+        return block;
+    }
+    if (pool->cursor == pool->limit) {
+        size_t header = roundUp(sizeof(Slab));
+        Slab *slab = malloc(header + pool->blockSize * pool->blocksPerSlab);
+        if (!slab) {
+            return NULL;
+        }
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        pool->slabCount++;
+        pool->cursor = (char *)slab + header;
+        pool->limit = pool->cursor + pool->blockSize * pool->blocksPerSlab;
+    }
+    void *block = pool->cursor;
+    pool->cursor += pool->blockSize;
+    return block;
+}
+
+// Function to release a block
+void poolRelease(pool pool, void *block) {
+    if (!pool || !block) {
+        return;
+    }
+    FreeBlock *freed = block;
+    freed->next = pool->released;
+    pool->released = freed;
+}
+
+// Adapters from the Allocator interface to the pool
+static void *allocateFromPool(void *context, size_t size) {
+    Pool *pool = context;
+    if (size > pool->blockSize) {
+        return NULL; // The pool only serves blocks of its own size
+    }
+    return poolAllocate(pool);
+}
+
+static void releaseToPool(void *context, void *block, size_t size) {
+    (void)size; // Every block of a pool has the pool's size
+    poolRelease((Pool *)context, block);
+}
+
+// Function to get an allocator drawing from a pool
+Allocator poolAllocator(pool pool) {
+    Allocator allocator = {allocateFromPool, releaseToPool, pool};
+    return allocator;
+}
+
+// Function to get the number of slabs allocated so far
+int getPoolSlabCount(pool pool) {
+    return pool ? pool->slabCount : 0;
+}
@@ -0,0 +1,64 @@
+
+#ifndef POOL_H
+#define POOL_H
+#include "Defs.h"
+#include "Allocator.h"
+
+/**
+ * @file Pool.h
+ * @brief A fixed-size block allocator for the nodes of the containers.
+ *
+ * A pool hands out blocks of a single size, carved from slabs holding many
+ * blocks side by side, so the nodes of a container sit next to each other
+ * in memory. Released blocks go to a free list and are handed out again
+ * before a new slab is started, so add/remove cycles reuse the same memory
+ * instead of fragmenting the heap. Slabs are only freed with the pool.
+ */
+
+/** A type for a pool handle. */
+typedef struct pool_s *pool;
+
+/**
+ * @brief Creates an empty pool.
+ * @param blockSize The size of every block, for example getListNodeSize() or getKeyValuePairSize().
+ * @param blocksPerSlab The number of blocks of each slab, or 0 for 256.
+ * @return A handle to the new pool, or NULL if the arguments are invalid or the allocation failed.
+ */
+pool createPool(size_t blockSize, int blocksPerSlab);
+
+/**
+ * @brief Destroys a pool and its slabs. Every block allocated from it becomes invalid.
+ * @param pool The pool to destroy.
+ */
+void destroyPool(pool pool);
+
+/**
+ * @brief Allocates a block, reusing a released one when there is one.
+ * @param pool The pool.
+ * @return The block, or NULL if the allocation failed.
+ */
+void *poolAllocate(pool pool);
+
+/**
+ * @brief Gives a block back to the pool.
+ * @param pool The pool the block came from.
+ * @param block The block.
+ */
+void poolRelease(pool pool, void *block);
+
+/**
+ * @brief Gets an allocator drawing from a pool, to hand to setListAllocator or setHashTableAllocator.
+ * Requests larger than the pool's block size fail.
+ * @param pool The pool.
+ * @return The allocator. It stays valid as long as the pool does.
+ */
+Allocator poolAllocator(pool pool);
+
+/**
+ * @brief Gets the number of slabs allocated so far.
+ * @param pool The pool.
+ * @return The number of slabs, or 0 if the pool is NULL.
+ */
+int getPoolSlabCount(pool pool);
+
+#endif //POOL_H
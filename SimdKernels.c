@@ -0,0 +1,115 @@
+#include "SimdKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define X86_KERNELS 1
+#endif
+
+static kernelLevel level = kernelScalar; // Instruction set the kernels run on
+static bool detected = false; // Whether the CPU was checked yet
+
+// Find the widest instruction set the CPU supports
+static kernelLevel widestLevel(void) {
+#ifdef X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return kernelAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return kernelSse2;
+    }
+#endif
+    return kernelScalar;
+}
+
+// Pick the instruction set on the first call
+static kernelLevel activeLevel(void) {
+    if (!detected) {
+        level = widestLevel();
+        detected = true;
+    }
+    return level;
+}
+
+// Function to get the current instruction set
+kernelLevel getKernelLevel(void) {
+    return activeLevel();
+}
+
+// Function to force a narrower instruction set
+kernelLevel setKernelLevel(kernelLevel wanted) {
+    kernelLevel widest = widestLevel();
+    level = wanted < widest ? wanted : widest;
+    detected = true;
+    return level;
+}
+
+// Scalar threshold activity, also used for the values left after the vector loops
+static void thresholdAddClampScalar(int *values, int count, int above, int addAbove, int decBelow, int low, int high) {
+    for (int i = 0; i < count; i++) {
+        int value = values[i] >= above ? values[i] + addAbove : values[i] - decBelow;
+        if (value < low) {
+            value = low;
+        }
+        if (value > high) {
+            value = high;
+        }
+        values[i] = value;
+    }
+}
+
+#ifdef X86_KERNELS
+// SSE2 threshold activity, 4 values at a time
+__attribute__((target("sse2")))
+static void thresholdAddClampSse2(int *values, int count, int above, int addAbove, int decBelow, int low, int high) {
+    __m128i vAbove = _mm_set1_epi32(above), vAdd = _mm_set1_epi32(addAbove), vDec = _mm_set1_epi32(-decBelow);
+    __m128i vLow = _mm_set1_epi32(low), vHigh = _mm_set1_epi32(high);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_loadu_si128((__m128i *)(values + i));
+        __m128i below = _mm_cmpgt_epi32(vAbove, x);
+        x = _mm_add_epi32(x, _mm_or_si128(_mm_and_si128(below, vDec), _mm_andnot_si128(below, vAdd)));
+        __m128i under = _mm_cmpgt_epi32(vLow, x); // No min/max on 32-bit ints before SSE4.1
+        x = _mm_or_si128(_mm_and_si128(under, vLow), _mm_andnot_si128(under, x));
+        __m128i over = _mm_cmpgt_epi32(x, vHigh);
+        x = _mm_or_si128(_mm_and_si128(over, vHigh), _mm_andnot_si128(over, x));
+        _mm_storeu_si128((__m128i *)(values + i), x);
+    }
+    thresholdAddClampScalar(values + i, count - i, above, addAbove, decBelow, low, high);
+}
+
+// AVX2 threshold activity, 8 values at a time
+__attribute__((target("avx2")))
+static void thresholdAddClampAvx2(int *values, int count, int above, int addAbove, int decBelow, int low, int high) {
+    __m256i vAbove = _mm256_set1_epi32(above), vAdd = _mm256_set1_epi32(addAbove), vDec = _mm256_set1_epi32(-decBelow);
+    __m256i vLow = _mm256_set1_epi32(low), vHigh = _mm256_set1_epi32(high);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i *)(values + i));
+        __m256i below = _mm256_cmpgt_epi32(vAbove, x);
+        x = _mm256_add_epi32(x, _mm256_blendv_epi8(vAdd, vDec, below));
+        x = _mm256_min_epi32(_mm256_max_epi32(x, vLow), vHigh);
+        _mm256_storeu_si256((__m256i *)(values + i), x);
+    }
+    thresholdAddClampScalar(values + i, count - i, above, addAbove, decBelow, low, high);
+}
+#endif
+
+// Function to apply a threshold activity to every value
+void thresholdAddClamp(int *values, int count, int above, int addAbove, int decBelow, int low, int high) {
+    if (!values || count <= 0) {
+        return;
+    }
+    switch (activeLevel()) {
+#ifdef X86_KERNELS
+        case kernelAvx2:
+            thresholdAddClampAvx2(values, count, above, addAbove, decBelow, low, high);
+            return;
+        case kernelSse2:
+            thresholdAddClampSse2(values, count, above, addAbove, decBelow, low, high);
+            return;
+#endif
+        default:
+            thresholdAddClampScalar(values, count, above, addAbove, decBelow, low, high);
+    }
+}
@@ -0,0 +1,45 @@
+
+#ifndef SIMDKERNELS_H
+#define SIMDKERNELS_H
+#include "Defs.h"
+
+/**
+ * @file SimdKernels.h
+ * @brief Vectorized loops over contiguous int arrays.
+ *
+ * Each kernel has an AVX2, an SSE2 and a scalar version, all giving the same
+ * results. The widest version the CPU supports is picked at run time on the
+ * first call, so the program needs no special compiler flags; on CPUs other
+ * than x86 only the scalar versions exist.
+ */
+
+/** The instruction sets a kernel can run on, from the narrowest to the widest. */
+typedef enum e_kernelLevel { kernelScalar, kernelSse2, kernelAvx2 } kernelLevel;
+
+/**
+ * @brief Gets the instruction set the kernels currently run on.
+ * @return The level picked at run time, or the one forced by setKernelLevel.
+ */
+kernelLevel getKernelLevel(void);
+
+/**
+ * @brief Forces the kernels to run on a narrower instruction set, to compare versions.
+ * @param level The level to run on. A level the CPU does not support is lowered to the widest supported one.
+ * @return The level the kernels now run on.
+ */
+kernelLevel setKernelLevel(kernelLevel level);
+
+/**
+ * @brief Applies a threshold activity to every value: values at or above the threshold
+ * gain addAbove, the others lose decBelow, and the result is clamped to [low, high].
+ * @param values The values, updated in place.
+ * @param count The number of values.
+ * @param above The threshold.
+ * @param addAbove Amount added to values at or above the threshold.
+ * @param decBelow Amount removed from values below the threshold.
+ * @param low Lowest result.
+ * @param high Highest result.
+ */
+void thresholdAddClamp(int *values, int count, int above, int addAbove, int decBelow, int low, int high);
+
+#endif //SIMDKERNELS_H
@@ -0,0 +1,198 @@
+// Allocator calls made by loading Jerries into the daycare's structures and closing it again,
+// with every record from malloc and with the records drawn from a daycare arena (see Arena.h).
+// malloc, calloc, realloc and free are counted by replacing them in this program (glibc only);
+// mmap and munmap by the linker's --wrap, as only the arena maps memory.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "Jerry.h"
+#include "HashTable.h"
+#include "LinkedList.h"
+#include "MultiValueHashTable.h"
+#include "Interner.h"
+#include "Arena.h"
+
+#define JERRY_COUNT 100000
+#define PLANET_COUNT 100
+
+// Numbers of allocator calls
+typedef struct {
+    long malloc, calloc, realloc, free, mmap, munmap;
+} CallCounts;
+
+static CallCounts calls; // Counted since the last reset
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *block, size_t size);
+extern void __libc_free(void *block);
+void *__real_mmap(void *address, size_t length, int protection, int flags, int fd, off_t offset);
+int __real_munmap(void *address, size_t length);
+
+void *malloc(size_t size) {
+    calls.malloc++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    calls.calloc++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *block, size_t size) {
+    calls.realloc++;
+    return __libc_realloc(block, size);
+}
+
+void free(void *block) {
+    calls.free += block != NULL;
+    __libc_free(block);
+}
+
+void *__wrap_mmap(void *address, size_t length, int protection, int flags, int fd, off_t offset) {
+    calls.mmap++;
+    return __real_mmap(address, length, protection, flags, fd, offset);
+}
+
+int __wrap_munmap(void *address, size_t length) {
+    calls.munmap++;
+    return __real_munmap(address, length);
+}
+
+// The element functions of the daycare's tables
+static Element internKey(Element key) {
+    return (Element)internedCopy((char *)key);
+}
+
+static Element jerryId(Element jerry) {
+    return (Element)getjerryid((Jerry *)jerry);
+}
+
+static status show(Element element) {
+    (void)element;
+    return success;
+}
+
+static status freeJerry(Element jerry) {
+    return free_jerry((Jerry *)jerry);
+}
+
+static bool sameString(Element key1, Element key2) {
+    return key1 == key2 || strcmp((char *)key1, (char *)key2) == 0;
+}
+
+static double pcScore(Element name, Element jerry) {
+    PhysicalCharacteristics *pc = get_pc_of_jerry((Jerry *)jerry, (char *)name);
+    return pc ? pc->val : 0;
+}
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Take the calls counted so far and reset the count
+static CallCounts takeCalls(void) {
+    CallCounts counted = calls;
+    memset(&calls, 0, sizeof(calls));
+    return counted;
+}
+
+static void printCalls(const char *phase, CallCounts counted) {
+    printf("    %-6s malloc %7ld  calloc %5ld  realloc %6ld  free %7ld  mmap %3ld  munmap %3ld\n", phase, counted.malloc,
+           counted.calloc, counted.realloc, counted.free, counted.mmap, counted.munmap);
+}
+
+// Load the Jerries, two characteristics each, the way the daycare does, then close it
+static int loadAndClose(bool useArena) {
+    takeCalls();
+    double start = now();
+    arena daycare = useArena ? createArena(0) : NULL;
+    Allocator daycareAllocator;
+    if (useArena) {
+        if (!daycare) {
+            return 1;
+        }
+        daycareAllocator = arenaAllocator(daycare);
+    }
+    const Allocator *allocator = useArena ? &daycareAllocator : NULL;
+    set_jerry_allocator(allocator);
+    setInternerAllocator(allocator);
+    Planet *planets[PLANET_COUNT];
+    linkedlist all = createLinkedList(borrowElement, keepElement, sameElement, show);
+    hashTable byId = createOpenHashTable(borrowElement, keepElement, show, borrowElement, freeJerry, show, sameString,
+                                         NULL, JERRY_COUNT);
+    multiValueHashTable byPc = createMultiValueHashTable(internKey, keepElement, show, borrowElement, keepElement, show,
+                                                         sameString, NULL, 61, sameElement);
+    if (!all || !byId || !byPc) {
+        return 1;
+    }
+    setKeyOfValue(byId, jerryId); // The table borrows each Jerry's ID, as the daycare's does
+    setListAllocator(all, allocator);
+    setMultiValueAllocator(byPc, allocator);
+    setMultiValueScoreFunction(byPc, pcScore);
+    char name[32];
+    for (int i = 0; i < PLANET_COUNT; i++) {
+        snprintf(name, sizeof(name), "Planet_%d", i);
+        planets[i] = create_planet(name, i, 2 * i, 3 * i);
+        if (!planets[i]) {
+            return 1;
+        }
+    }
+    for (int i = 0; i < JERRY_COUNT; i++) {
+        snprintf(name, sizeof(name), "J%d", i);
+        Jerry *jerry = create_jerry(name, "C-137", planets[i % PLANET_COUNT], i % 101);
+        if (!jerry || addToHashTable(byId, name, jerry) == failure || !appendNodeWithHandle(all, jerry)) {
+            return 1;
+        }
+        PhysicalCharacteristics *height = add_pc_to_jerry(jerry, "Height", 100 + i % 80);
+        if (!height || !(height->entry = addToMultiValueHashTableWithHandle(byPc, "Height", jerry))) {
+            return 1;
+        }
+        PhysicalCharacteristics *weight = add_pc_to_jerry(jerry, "Weight", 50 + i % 60);
+        if (!weight || !(weight->entry = addToMultiValueHashTableWithHandle(byPc, "Weight", jerry))) {
+            return 1;
+        }
+    }
+    double loaded = now();
+    CallCounts loadCalls = takeCalls();
+    destroyMultiValueHashTable(byPc);
+    destroyHashTable(byId); // Frees the Jerries
+    destroyList(all);
+    for (int i = 0; i < PLANET_COUNT; i++) {
+        free_planet(planets[i]);
+    }
+    destroyInterner();
+    destroyArena(daycare);
+    set_jerry_allocator(NULL);
+    double closed = now();
+    CallCounts closeCalls = takeCalls();
+    printf("  %s (load %.2f s, close %.2f s)\n", useArena ? "arena" : "malloc", loaded - start, closed - loaded);
+    printCalls("load", loadCalls);
+    printCalls("close", closeCalls);
+    return 0;
+}
+
+// Run a pass in a child process, so it does not inherit the heap the other pass left behind
+static int runPass(bool useArena) {
+    fflush(stdout);
+    pid_t child = fork();
+    if (child < 0) {
+        return 1;
+    }
+    if (child == 0) {
+        exit(loadAndClose(useArena));
+    }
+    int result;
+    return waitpid(child, &result, 0) != child || !WIFEXITED(result) || WEXITSTATUS(result) != 0;
+}
+
+int main(void) {
+    printf("%d Jerries with two characteristics each, from %d planets\n", JERRY_COUNT, PLANET_COUNT);
+    return runPass(false) || runPass(true);
+}
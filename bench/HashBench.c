@@ -0,0 +1,91 @@
+// Bucket distribution and throughput of the string hash strategies (see HashTable.h),
+// on structured Jerry IDs, against the character sum jerry2num the Jerry table used to hash with.
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "HashTable.h"
+
+#define ID_COUNT 100000
+#define BUCKETS 100003 // The prime the daycare sizes a table of ID_COUNT keys with
+#define PASSES 20
+
+// The former Jerry ID hash: letters by code, digits by value, so permuted IDs collide
+static int jerry2num(Element id) {
+    int sum = 0;
+    for (char *ch = (char *)id; *ch; ch++) {
+        if (isalpha((unsigned char)*ch)) {
+            sum += *ch;
+        } else if (isdigit((unsigned char)*ch)) {
+            sum += *ch - '0';
+        }
+    }
+    return sum;
+}
+
+static unsigned long long legacyHash(Element key, unsigned long long seed) {
+    (void)seed;
+    return (unsigned int)jerry2num(key); // Reduced modulo the table size as the old table did
+}
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Print the chain lengths a strategy gives the IDs, and how fast it hashes them
+static void measure(const char *name, SeededHashFunction hash, unsigned long long seed, char **ids) {
+    static int chains[BUCKETS];
+    memset(chains, 0, sizeof(chains));
+    int longest = 0;
+    for (int i = 0; i < ID_COUNT; i++) {
+        int bucket = (int)(hash(ids[i], seed) % BUCKETS);
+        if (++chains[bucket] > longest) {
+            longest = chains[bucket];
+        }
+    }
+    double squares = 0;
+    int used = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        squares += (double)chains[i] * chains[i];
+        used += chains[i] > 0;
+    }
+    volatile unsigned long long sink = 0; // Keeps the hashing from being optimized away
+    double start = now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        for (int i = 0; i < ID_COUNT; i++) {
+            sink += hash(ids[i], seed);
+        }
+    }
+    double perHash = (now() - start) / ((double)PASSES * ID_COUNT) * 1e9;
+    printf("%-9s buckets used %6d  longest chain %5d  sum of squares %10.0f  %5.1f ns/hash\n", name, used, longest,
+           squares, perHash);
+}
+
+int main(void) {
+    char **ids = malloc(ID_COUNT * sizeof(char *));
+    if (!ids) {
+        return 1;
+    }
+    for (int i = 0; i < ID_COUNT; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "Jerry_%d", i);
+        ids[i] = strdup(id);
+        if (!ids[i]) {
+            return 1;
+        }
+    }
+    double n = ID_COUNT, m = BUCKETS;
+    printf("%d IDs Jerry_<n> in %d buckets, ideal sum of squared chain lengths %.0f\n", ID_COUNT, BUCKETS,
+           n + n * (n - 1) / m);
+    measure("jerry2num", legacyHash, 0, ids);
+    measure("FNV-1a", hashStringFNV1a, 0, ids);
+    measure("wy", hashStringWy, randomHashSeed(), ids);
+    for (int i = 0; i < ID_COUNT; i++) {
+        free(ids[i]);
+    }
+    free(ids);
+    return 0;
+}
@@ -0,0 +1,65 @@
+// Throughput of the threshold activity kernel (see SimdKernels.h) at every instruction set the CPU supports,
+// in Jerries per second: one value per Jerry, as in the happiness column of the Jerry store.
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "SimdKernels.h"
+
+#define JERRY_COUNT 1000000
+#define RUNS 20
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Best time of a few activities over the values, each starting from the same levels
+static double bestActivityTime(int *values, const int *levels) {
+    double best = 1e9;
+    for (int run = 0; run < RUNS; run++) {
+        for (int i = 0; i < JERRY_COUNT; i++) {
+            values[i] = levels[i];
+        }
+        double start = now();
+        thresholdAddClamp(values, JERRY_COUNT, 50, 15, 5, 0, 100);
+        double time = now() - start;
+        best = time < best ? time : best;
+    }
+    return best;
+}
+
+int main(void) {
+    static const char *names[] = {"scalar", "sse2", "avx2"};
+    int *levels = malloc(JERRY_COUNT * sizeof(int));
+    int *values = malloc(JERRY_COUNT * sizeof(int));
+    int *expected = malloc(JERRY_COUNT * sizeof(int));
+    if (!levels || !values || !expected) {
+        return 1;
+    }
+    srand(1);
+    for (int i = 0; i < JERRY_COUNT; i++) {
+        levels[i] = rand() % 101;
+    }
+    printf("%d Jerries, best of %d activities\n", JERRY_COUNT, RUNS);
+    for (kernelLevel wanted = kernelScalar; wanted <= kernelAvx2; wanted++) {
+        if (setKernelLevel(wanted) != wanted) {
+            printf("  %-6s not supported by this CPU\n", names[wanted]);
+            continue;
+        }
+        double time = bestActivityTime(values, levels);
+        bool same = true; // Every version must give the scalar results
+        for (int i = 0; i < JERRY_COUNT; i++) {
+            if (wanted == kernelScalar) {
+                expected[i] = values[i];
+            } else if (values[i] != expected[i]) {
+                same = false;
+            }
+        }
+        printf("  %-6s %7.0f M Jerries/s%s\n", names[wanted], JERRY_COUNT / time / 1e6, same ? "" : "  MISMATCH");
+    }
+    free(levels);
+    free(values);
+    free(expected);
+    return 0;
+}
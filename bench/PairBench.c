@@ -0,0 +1,146 @@
+// Heap bytes per entry of a one-million-key hash table, excluding the keys and values themselves:
+// the current chained and open addressing tables against the layout the table had before PairTraits,
+// where every pair carried its own function pointers and every used bucket was a linked list.
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "HashTable.h"
+
+#define KEY_COUNT 1000000
+#define BUCKETS 1000003 // The prime the daycare sizes a table of KEY_COUNT keys with
+
+// The former pair: key, value and seven functions
+typedef struct {
+    Element key;
+    Element value;
+    CopyFunction copyKey;
+    CopyFunction copyValue;
+    EqualFunction compareKey;
+    FreeFunction destroyKey;
+    FreeFunction destroyValue;
+    PrintFunction printKey;
+    PrintFunction printValue;
+} LegacyPair;
+
+// The former list node and list, one list per used bucket
+typedef struct LegacyNode {
+    Element data;
+    struct LegacyNode *next;
+} LegacyNode;
+
+typedef struct {
+    LegacyNode *head;
+    int size;
+    CopyFunction copy;
+    FreeFunction free;
+    EqualFunction compare;
+    PrintFunction print;
+} LegacyList;
+
+static Element identity(Element element) {
+    return element;
+}
+
+static status keep(Element element) {
+    (void)element;
+    return success;
+}
+
+static status show(Element element) {
+    (void)element;
+    return success;
+}
+
+static bool sameString(Element key1, Element key2) {
+    return strcmp((char *)key1, (char *)key2) == 0;
+}
+
+// Bytes currently allocated from the heap
+static size_t heapInUse(void) {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+}
+
+// Insert every key the way the former table did: a bucket array, a list per used bucket, a node and a pair per key
+static double legacyBytesPerEntry(char **keys) {
+    size_t before = heapInUse();
+    LegacyList **buckets = calloc(BUCKETS, sizeof(LegacyList *));
+    if (!buckets) {
+        return -1;
+    }
+    for (int i = 0; i < KEY_COUNT; i++) {
+        int bucket = (int)(hashStringFNV1a(keys[i], 0) % BUCKETS);
+        if (!buckets[bucket]) {
+            buckets[bucket] = calloc(1, sizeof(LegacyList));
+        }
+        LegacyPair *pair = malloc(sizeof(LegacyPair));
+        LegacyNode *node = malloc(sizeof(LegacyNode));
+        if (!buckets[bucket] || !pair || !node) {
+            return -1;
+        }
+        *pair = (LegacyPair){keys[i], keys[i], identity, identity, sameString, keep, keep, show, show};
+        node->data = pair;
+        node->next = buckets[bucket]->head;
+        buckets[bucket]->head = node;
+        buckets[bucket]->size++;
+    }
+    double perEntry = (double)(heapInUse() - before) / KEY_COUNT;
+    for (int i = 0; i < BUCKETS; i++) {
+        if (!buckets[i]) {
+            continue;
+        }
+        for (LegacyNode *node = buckets[i]->head, *next; node; node = next) {
+            next = node->next;
+            free(node->data);
+            free(node);
+        }
+        free(buckets[i]);
+    }
+    free(buckets);
+    return perEntry;
+}
+
+// Insert every key into a table of the library and measure what it allocated
+static double tableBytesPerEntry(hashTable (*create)(CopyFunction, FreeFunction, PrintFunction, CopyFunction,
+                                                     FreeFunction, PrintFunction, EqualFunction,
+                                                     TransformIntoNumberFunction, int),
+                                 char **keys) {
+    size_t before = heapInUse();
+    hashTable table = create(identity, keep, show, identity, keep, show, sameString, NULL, BUCKETS);
+    if (!table) {
+        return -1;
+    }
+    for (int i = 0; i < KEY_COUNT; i++) {
+        if (addToHashTable(table, keys[i], keys[i]) == failure) {
+            return -1;
+        }
+    }
+    double perEntry = (double)(heapInUse() - before) / KEY_COUNT;
+    destroyHashTable(table);
+    return perEntry;
+}
+
+int main(void) {
+    char **keys = malloc(KEY_COUNT * sizeof(char *));
+    if (!keys) {
+        return 1;
+    }
+    for (int i = 0; i < KEY_COUNT; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), "key_%d", i);
+        keys[i] = strdup(key);
+        if (!keys[i]) {
+            return 1;
+        }
+    }
+    printf("%d keys, %d buckets, heap bytes per entry without keys and values\n", KEY_COUNT, BUCKETS);
+    printf("  pair with its own functions, list per bucket: %6.1f\n", legacyBytesPerEntry(keys));
+    printf("  chained table, shared PairTraits:             %6.1f\n", tableBytesPerEntry(createHashTable, keys));
+    printf("  open addressing table:                        %6.1f\n", tableBytesPerEntry(createOpenHashTable, keys));
+    for (int i = 0; i < KEY_COUNT; i++) {
+        free(keys[i]);
+    }
+    free(keys);
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Add/remove churn on a linked list and a chained hash table, with their nodes from malloc, from an arena's
+// size-class free lists (see Arena.h) and from a pool (see Pool.h). Odd-sized mallocs are interleaved with the churn, as in a long session. Each run happens in
+// its own process so that its resident set size is its own.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "HashTable.h"
+#include "LinkedList.h"
+#include "KeyValuePair.h"
+#include "Arena.h"
+#include "Pool.h"
+
+#define ENTRY_COUNT 200000
+#define CHURN_COUNT 2000000 // Each one removes a random entry and adds it back
+#define NOISE_COUNT 1000 // Odd-sized blocks kept alive, one replaced per churn
+
+static Element copyString(Element key) {
+    char *copy = malloc(strlen((char *)key) + 1);
+    return copy ? strcpy(copy, (char *)key) : NULL;
+}
+
+static status freeString(Element key) {
+    free(key);
+    return success;
+}
+
+static status show(Element element) {
+    (void)element;
+    return success;
+}
+
+static bool sameString(Element key1, Element key2) {
+    return strcmp((char *)key1, (char *)key2) == 0;
+}
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Resident set size of this process, in KiB
+static long residentKiB(void) {
+    FILE *status = fopen("/proc/self/status", "r");
+    char line[256];
+    long kib = -1;
+    while (status && fgets(line, sizeof(line), status)) {
+        if (sscanf(line, "VmRSS: %ld", &kib) == 1) {
+            break;
+        }
+    }
+    if (status) {
+        fclose(status);
+    }
+    return kib;
+}
+
+// Replace one of the odd-sized blocks
+static void makeNoise(void **noise) {
+    int victim = rand() % NOISE_COUNT;
+    free(noise[victim]);
+    noise[victim] = malloc(24 + rand() % 200);
+}
+
+// Churn the entries of a list, reached through their node handles
+static int churnList(const Allocator *allocator, char **keys, void **noise) {
+    linkedlist list = createLinkedList(borrowElement, keepElement, sameString, show);
+    listNode *nodes = malloc(ENTRY_COUNT * sizeof(listNode));
+    if (!list || !nodes || setListAllocator(list, allocator) == failure) {
+        return 1;
+    }
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        nodes[i] = appendNodeWithHandle(list, keys[i]);
+    }
+    for (long churn = 0; churn < CHURN_COUNT; churn++) {
+        int entry = rand() % ENTRY_COUNT;
+        removeNodeByHandle(list, nodes[entry]);
+        nodes[entry] = appendNodeWithHandle(list, keys[entry]);
+        if (!nodes[entry]) {
+            return 1;
+        }
+        makeNoise(noise);
+    }
+    free(nodes);
+    destroyList(list);
+    return 0;
+}
+
+// Churn the keys of a chained hash table
+static int churnHash(const Allocator *allocator, char **keys, void **noise) {
+    hashTable table = createHashTable(copyString, freeString, show, borrowElement, keepElement, show, sameString, NULL,
+                                      ENTRY_COUNT);
+    if (!table || setHashTableAllocator(table, allocator) == failure) {
+        return 1;
+    }
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        addToHashTable(table, keys[i], keys[i]);
+    }
+    for (long churn = 0; churn < CHURN_COUNT; churn++) {
+        int entry = rand() % ENTRY_COUNT;
+        removeFromHashTable(table, keys[entry]);
+        if (addToHashTable(table, keys[entry], keys[entry]) == failure) {
+            return 1;
+        }
+        makeNoise(noise);
+    }
+    destroyHashTable(table);
+    return 0;
+}
+
+// Where the churned nodes come from
+typedef enum { fromMalloc, fromArena, fromPool } NodeSource;
+
+// Run one churn in a child process and print its throughput and resident set size
+static void run(const char *name, bool hash, NodeSource source) {
+    fflush(stdout);
+    pid_t child = fork();
+    if (child != 0) {
+        waitpid(child, NULL, 0);
+        return;
+    }
+    srand(1);
+    char **keys = malloc(ENTRY_COUNT * sizeof(char *));
+    void **noise = calloc(NOISE_COUNT, sizeof(void *));
+    if (!keys || !noise) {
+        exit(1);
+    }
+    for (int i = 0; i < ENTRY_COUNT; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), "key_%d", i);
+        keys[i] = copyString(key);
+    }
+    Allocator nodeAllocator;
+    if (source == fromArena) {
+        arena nodes = createArena(0);
+        if (!nodes) {
+            exit(1);
+        }
+        nodeAllocator = arenaAllocator(nodes);
+    } else if (source == fromPool) {
+        pool nodes = createPool(hash ? getKeyValuePairSize() : getListNodeSize(), 0);
+        if (!nodes) {
+            exit(1);
+        }
+        nodeAllocator = poolAllocator(nodes);
+    }
+    const Allocator *allocator = source == fromMalloc ? NULL : &nodeAllocator;
+    double start = now();
+    int failed = hash ? churnHash(allocator, keys, noise) : churnList(allocator, keys, noise);
+    double time = now() - start;
+    long kib = residentKiB();
+    printf("  %-22s %5.2f M ops/s  RSS %6ld KiB%s\n", name, CHURN_COUNT / time / 1e6, kib, failed ? "  FAILED" : "");
+    exit(failed);
+}
+
+int main(void) {
+    printf("%d entries, %d random remove+add, %d odd-sized blocks churned alongside\n", ENTRY_COUNT, CHURN_COUNT,
+           NOISE_COUNT);
+    run("list, malloc", false, fromMalloc);
+    run("list, arena", false, fromArena);
+    run("list, pool", false, fromPool);
+    run("chained hash, malloc", true, fromMalloc);
+    run("chained hash, arena", true, fromArena);
+    run("chained hash, pool", true, fromPool);
+    return 0;
+}